@@ -1,12 +1,25 @@
 #include "app.h"
 
 #include <atomic>
+#include <thread>
 
 extern std::atomic<bool> isRunning; //TODO:
 extern std::atomic<bool> shouldExit;
 
-App::App(const char *filename) {
-    clock_msec = (1000/clock_hz);
+App::App(const char *filename, const EmuSettings &settings)
+    : pacer(std::chrono::microseconds(settings.spinUs)), upscaler(settings.upscale) {
+    cpu_hz = settings.cpuHz;
+    vsyncLocked = settings.vsync;
+    frameSkip = settings.frameSkip;
+    minimizedMode = settings.minimized;
+    rtPriority = settings.rtPriority;
+    cpuAffinity = settings.cpuAffinity;
+    unfocusedMode = settings.unfocused;
+    for (int c = 0; c < 3; ++c) {
+        int shift = 16 - c * 8;
+        background[c] = static_cast<GLfloat>((settings.theme[0] >> shift) & 0xFFU) / 255.0f;
+        foreground[c] = static_cast<GLfloat>((settings.theme[1] >> shift) & 0xFFU) / 255.0f;
+    }
 
     initializeGLFW();
     initializeSDL();
@@ -14,9 +27,29 @@ App::App(const char *filename) {
     setupObject();
 
     chip8Console.loadROM(filename); //TODO: Exit if failed to load
+
+    runAheadFrames = settings.runAhead;
+    if (runAheadFrames > 0 && cpu_hz <= 0.) {
+        std::cout << "Run-Ahead needs a fixed cpu_hz, disabled" << std::endl;
+        runAheadFrames = 0;
+    }
+    if (runAheadFrames > 0) {
+        runAheadConsole = chip8Console;     //Shares the ROM image
+        runAheadState = std::make_unique<Chip8::State>();
+    }
 }
 
 App::~App() {
+    for (GLsync fence : pixelFences) {
+        if (fence) {
+            glDeleteSync(fence);
+        }
+    }
+    if (pixelRing) {
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    }
+    glDeleteBuffers(1, &pixelBuffer);
+
     glUseProgram(0);
     glDeleteBuffers(1, &vertexBuffer);
     glDeleteVertexArrays(1, &vertexArrayID);
@@ -33,7 +66,8 @@ App::~App() {
 void App::initializeGLFW() {
     glfwInit();
     
-    glfwWindowHint(GLFW_SAMPLES, 4);
+    glfwWindowHint(GLFW_SAMPLES, 0);       //One axis-aligned quad : no multisampling
+    glfwWindowHint(GLFW_DEPTH_BITS, 0);    //and no depth buffer
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
@@ -65,6 +99,9 @@ void App::initializeGLFW() {
 void App::setGLFWCallback() {
     glfwSetKeyCallback(window, ::keyCallback);
     glfwSetFramebufferSizeCallback(window, ::frameBufferResizeCallback);
+    glfwSetWindowFocusCallback(window, ::windowFocusCallback);
+    glfwSetWindowIconifyCallback(window, ::windowIconifyCallback);
+    glfwSetWindowRefreshCallback(window, ::windowRefreshCallback);
     
     #ifdef _DEBUG
     if (glDebugMessageCallback != NULL) {
@@ -78,10 +115,9 @@ void App::setGLFWCallback() {
 }
 
 // Set up VAO, Texture, VBO, Shader
+// All state a frame needs is bound here once; draw() only uploads and draws
 void App::setupObject() {
-    glClearColor(0, 0, 0, 0);
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LESS);
+    glDisable(GL_DEPTH_TEST);   //One 2D quad, nothing to sort
     glDisable(GL_CULL_FACE);
 
     //VAO
@@ -90,60 +126,190 @@ void App::setupObject() {
 
     //Setup Texture
     glGenTextures(1, &textureID);
+    glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, VIDEO_WIDTH, VIDEO_HEIGHT,
-                 0, GL_RGBA, GL_UNSIGNED_BYTE, chip8Console.video_frame);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    upscaler.apply(chip8Console.display, ~0U);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8UI, upscaler.rowBytes(), upscaler.outputHeight(),
+                 0, GL_RED_INTEGER, GL_UNSIGNED_BYTE, upscaler.row(0));
+
+    //Integer textures are only complete with NEAREST filtering
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 
-    //VBO
+    //VBO, recorded into the VAO
     glGenBuffers(1, &vertexBuffer);
     glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
     glBufferData(GL_ARRAY_BUFFER, sizeof(frame_vertex), frame_vertex, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, NULL);
+
+    setupPixelRing();
 
-    //Load Program
-    shaderID = LoadShaders("shaders/vertex.glsl", "shaders/frag.glsl");
+    //Load Program and resolve uniforms
+    shaderID = LoadShaders("vertex.glsl", "frag.glsl");
+    glUseProgram(shaderID);
+    glUniform1i(glGetUniformLocation(shaderID, "displaySampler"), 0);
+    glUniform4fv(glGetUniformLocation(shaderID, "foreground"), 1, foreground);
+    glUniform4fv(glGetUniformLocation(shaderID, "background"), 1, background);
 }
 
-//Draw video_frame Output
-void App::draw() {
+/**
+ * PBO ring for texture uploads, mapped once and left mapped
+ * Stays bound to GL_PIXEL_UNPACK_BUFFER so glTexSubImage2D reads from it
+ * and returns without copying client memory. Without GL_ARB_buffer_storage
+ * uploads come straight from the frame as before.
+ */
+void App::setupPixelRing() {
+    if (!GLEW_ARB_buffer_storage) {
+        std::cout << "Texture Upload : client memory (no GL_ARB_buffer_storage)" << std::endl;
+        return;
+    }
 
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const GLsizeiptr size = pixelSlotBytes() * PIXEL_RING_SLOTS;
 
-    //Draw Frame
-    glUseProgram(shaderID);
-    glBindVertexArray(vertexArrayID);
+    glGenBuffers(1, &pixelBuffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+    glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size, nullptr, flags);
+    pixelRing = static_cast<uint8_t *>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, flags));
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, VIDEO_WIDTH, VIDEO_HEIGHT, 
-                    GL_RGBA, GL_UNSIGNED_BYTE, chip8Console.video_frame);
+    if (!pixelRing) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glDeleteBuffers(1, &pixelBuffer);
+        pixelBuffer = 0;
+        std::cout << "Texture Upload : client memory (PBO mapping failed)" << std::endl;
+        return;
+    }
+    std::cout << "Texture Upload : persistent PBO ring, " << PIXEL_RING_SLOTS << " slots" << std::endl;
+}
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    // glGenerateMipmap(GL_TEXTURE_2D);
+// A slot is reusable once the GPU has consumed the upload fenced on it; never waits
+bool App::pixelSlotFree(int slot) {
+    if (!pixelFences[slot]) {
+        return true;
+    }
 
-    glUniform1i(glGetUniformLocation(shaderID, "textureSampler"), 0);
+    GLenum status = glClientWaitSync(pixelFences[slot], 0, 0);
+    ++glCalls;
+    if (status == GL_TIMEOUT_EXPIRED || status == GL_WAIT_FAILED) {
+        return false;
+    }
+
+    glDeleteSync(pixelFences[slot]);
+    pixelFences[slot] = nullptr;
+    ++glCalls;
+    return true;
+}
+
+// One slot holds a whole texture : the display, or its upscaled image
+size_t App::pixelSlotBytes() const {
+    return upscaler.rowBytes() * upscaler.outputHeight();
+}
+
+void App::uploadRows(const uint8_t *rows, int first, int count) {
+    const GLsizei width = upscaler.rowBytes();
+    GLsizeiptr bytes = count * width;
+
+    if (pixelRing && pixelSlotFree(pixelSlot)) {
+        GLintptr offset = pixelSlot * pixelSlotBytes();
+        std::memcpy(pixelRing + offset, rows, bytes);
+
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, first, width, count,
+                        GL_RED_INTEGER, GL_UNSIGNED_BYTE, reinterpret_cast<const void *>(offset));
+        pixelFences[pixelSlot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        pixelSlot = (pixelSlot + 1) % PIXEL_RING_SLOTS;
+        glCalls += 2;
+        return;
+    }
+
+    //Whole ring in flight : upload this one from client memory rather than wait
+    if (pixelRing) {
+        ++pixelRingBusy;
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, first, width, count,
+                    GL_RED_INTEGER, GL_UNSIGNED_BYTE, rows);
+    ++glCalls;
+    if (pixelRing) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+        glCalls += 2;
+    }
+}
+
+//Draw a completed frame, uploading only the span of rows that changed
+//Changed rows pass through the upscaler first, which also touches their neighbours
+//The quad covers the whole viewport, so there is nothing to clear
+void App::draw(const VideoFrame &frame, uint32_t dirtyRows) {
+    if (dirtyRows) {
+        upscaler.apply(frame.display, dirtyRows);
+        uint32_t rows = Upscaler::affectedRows(dirtyRows);
+
+        int first = 0, last = VIDEO_HEIGHT - 1;
+        while (!(rows & (1U << first))) {
+            ++first;
+        }
+        while (!(rows & (1U << last))) {
+            --last;
+        }
+
+        int n = upscaler.factor();
+        uploadRows(upscaler.row(first * n), first * n, (last - first + 1) * n);
+        uploadedRows += last - first + 1;
+    }
 
-    glEnableVertexAttribArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, NULL);
-    
     glDrawArrays(GL_TRIANGLES, 0, 6);
+    ++glCalls;
+}
+
+//Render statistics for the last report interval
+void App::reportRender(const char *name) {
+    uint64_t frames = std::max<uint64_t>(renderHistogram.samples(), 1);
 
-    glDisableVertexAttribArray(0);
+    std::cout << renderHistogram.summary(name) << std::endl;
+    std::cout << "Texture Upload : " << uploadedRows << " of " << renderHistogram.samples() * VIDEO_HEIGHT
+              << " rows | GL Calls : " << glCalls << " (" << static_cast<double>(glCalls) / frames
+              << " per frame)";
+    if (pixelRing) {
+        std::cout << " | PBO Ring Busy : " << pixelRingBusy;
+    }
+    std::cout << std::endl;
+
+    renderHistogram.clear();
+    uploadedRows = 0;
+    glCalls = 0;
+    pixelRingBusy = 0;
 }
 
-// GLFW Key Callback
+// GLFW Key Callback : keypad changes are handed to the emulation thread
 void App::keyCallback(int key, int scancode, int action, int mods) {
     auto idx = std::distance(keyMapping.begin(), std::find(keyMapping.begin(), keyMapping.end(), key));
     
+    if (idx < static_cast<long>(keyMapping.size())) {
+        if (action == GLFW_PRESS) {
+            keyState.fetch_or(1U << idx, std::memory_order_relaxed);
+        } else if (action == GLFW_RELEASE) {
+            keyState.fetch_and(~(1U << idx), std::memory_order_relaxed);
+        }
+    }
+
+    if (key == GLFW_KEY_ENTER && action == GLFW_PRESS) {
+        resetRequested.store(true, std::memory_order_relaxed);
+    }
+
+    //Speed : F1 slower, F2 faster, F3 normal, hold TAB to fast-forward
     if (action == GLFW_PRESS) {
-        chip8Console.keypad[idx] = 1;
-    } else if (action == GLFW_RELEASE) {
-        chip8Console.keypad[idx] = 0;
+        if (key == GLFW_KEY_F1) {
+            setSpeedLevel(speedLevel.load(std::memory_order_relaxed) - 1);
+        } else if (key == GLFW_KEY_F2) {
+            setSpeedLevel(speedLevel.load(std::memory_order_relaxed) + 1);
+        } else if (key == GLFW_KEY_F3) {
+            setSpeedLevel(NORMAL_SPEED);
+        }
     }
 
-    if (key == GLFW_KEY_ENTER) {
-        chip8Console.reset();
+    if (key == GLFW_KEY_TAB && action != GLFW_REPEAT) {
+        turboHeld.store(action == GLFW_PRESS, std::memory_order_relaxed);
     }
 
     if (key == GLFW_KEY_ESCAPE) {
@@ -157,6 +323,39 @@ void App::frameBufferResizeCallback(int width, int height) {
     screenHeight = height;
     glViewport(0, 0, width, height);
     ratio = (float)width/height;
+    needsRedraw = true;
+}
+
+// GLFW Refresh Callback : contents damaged while no new frame may arrive
+void App::windowRefreshCallback() {
+    needsRedraw = true;
+}
+
+// GLFW Focus and Iconify Callbacks : throttle emulation while in the background
+void App::windowFocusCallback(int focused) {
+    setWindowState(windowFocused, focused == GLFW_TRUE);
+}
+
+void App::windowIconifyCallback(int iconified) {
+    setWindowState(windowIconified, iconified == GLFW_TRUE);
+}
+
+void App::setWindowState(std::atomic<bool> &flag, bool value) {
+    {
+        std::lock_guard<std::mutex> lock(backgroundMutex);
+        flag.store(value, std::memory_order_relaxed);
+    }
+    backgroundChanged.notify_all();
+}
+
+BackgroundMode App::backgroundMode() const {
+    if (windowIconified.load(std::memory_order_relaxed)) {
+        return minimizedMode;
+    }
+    if (!windowFocused.load(std::memory_order_relaxed)) {
+        return unfocusedMode;
+    }
+    return BackgroundMode::RUN;
 }
 
 // Pseudo GLFW Callback
@@ -170,6 +369,21 @@ void frameBufferResizeCallback(GLFWwindow* window, int width, int height) {
     app_ptr->frameBufferResizeCallback(width, height);
 }
 
+void windowFocusCallback(GLFWwindow* window, int focused) {
+    App *app_ptr = reinterpret_cast<App *>(glfwGetWindowUserPointer(window));
+    app_ptr->windowFocusCallback(focused);
+}
+
+void windowIconifyCallback(GLFWwindow* window, int iconified) {
+    App *app_ptr = reinterpret_cast<App *>(glfwGetWindowUserPointer(window));
+    app_ptr->windowIconifyCallback(iconified);
+}
+
+void windowRefreshCallback(GLFWwindow* window) {
+    App *app_ptr = reinterpret_cast<App *>(glfwGetWindowUserPointer(window));
+    app_ptr->windowRefreshCallback();
+}
+
 // Initialize SDL and generate sound wave
 void App::initializeSDL() {
     if (SDL_Init(SDL_INIT_AUDIO) < 0) {
@@ -201,26 +415,385 @@ void App::beep() {
     SDL_QueueAudio(audioDeviceID, audioBuffer.data(), audioLength);
 }
 
-//Main Loop
-void App::mainLoop() {
-    auto lastCycleTime = std::chrono::high_resolution_clock::now();
+double App::speedMultiplier() const {
+    if (turboHeld.load(std::memory_order_relaxed)) {
+        return 0.;
+    }
+    return SPEED_LEVELS[speedLevel.load(std::memory_order_relaxed)];
+}
+
+void App::setSpeedLevel(int level) {
+    level = std::clamp(level, 0, static_cast<int>(SPEED_LEVELS.size()) - 1);
+    speedLevel.store(level, std::memory_order_relaxed);
+    std::cout << "Speed : " << speedLabel() << std::endl;
+}
+
+std::string App::speedLabel() const {
+    double multiplier = speedMultiplier();
+    if (multiplier <= 0.) {
+        return "Unlimited";
+    }
+
     std::stringstream ss;
-    bool playSound = false;
+    ss << multiplier << "x";
+    return ss.str();
+}
+
+/**
+ * Run one 60 Hz frame worth of instructions, then tick the timers
+ * cpu_hz / clock_hz is rarely whole, the remainder carries to the next frame
+ * Unlimited (cpu_hz = 0) runs until the frame deadline
+ */
+void App::emulateFrame(std::chrono::steady_clock::time_point deadline) {
+    if (resetRequested.exchange(false, std::memory_order_relaxed)) {
+        chip8Console.reset();
+    }
+
+    uint16_t keys = keyState.load(std::memory_order_relaxed);
+    for (int i = 0; i < 16; ++i) {
+        chip8Console.keypad[i] = (keys >> i) & 1U;
+    }
 
+    uint64_t executed = 0;
+    if (cpu_hz > 0.) {
+        cycleCarry += cpu_hz / clock_hz;
+        auto cycles = static_cast<uint32_t>(cycleCarry);
+        cycleCarry -= cycles;
+
+        for (uint32_t i = 0; i < cycles; ++i) {
+            chip8Console.cycle();
+        }
+        executed = cycles;
+        lastFrameCycles = cycles;
+    } else {
+        constexpr uint32_t BATCH = 1024;
+        do {
+            for (uint32_t i = 0; i < BATCH; ++i) {
+                chip8Console.cycle();
+            }
+            executed += BATCH;
+        } while (std::chrono::steady_clock::now() < deadline);
+    }
+    instructionCount.fetch_add(executed, std::memory_order_relaxed);
+
+    //Above 1x only one beep is kept queued, so audio never lags behind the game
+    if (chip8Console.clock_tick()) {
+        double multiplier = speedMultiplier();
+        if ((multiplier > 0. && multiplier <= 1.) || SDL_GetQueuedAudioSize(audioDeviceID) == 0) {
+            beep();
+        }
+    }
+}
+
+// Real-time priority and CPU pinning from [Realtime], applied by the emulating thread itself
+void App::tuneEmulationThread() {
+    if (rtPriority > 0) {
+        bool ok = setRealtimePriority(rtPriority);
+        std::cout << "Emulation Thread : SCHED_FIFO " << rtPriority << (ok ? "" : " refused") << std::endl;
+    }
+
+    if (cpuAffinity >= 0) {
+        bool ok = pinToCpu(cpuAffinity);
+        std::cout << "Emulation Thread : CPU " << cpuAffinity << (ok ? "" : " refused") << std::endl;
+    }
+}
+
+/**
+ * Run-Ahead : the frame to present, runAheadFrames frames past chip8Console
+ * The shadow console is restored from the real one and run ahead with the
+ * current keys, so input shows up that many frames earlier. Its beeps are
+ * dropped; the real console beeps when it gets there.
+ */
+const Chip8 &App::runAhead() {
+    if (runAheadFrames <= 0) {
+        return chip8Console;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    chip8Console.clone(*runAheadState);
+    runAheadConsole.restore(*runAheadState);
+    for (int f = 0; f < runAheadFrames; ++f) {
+        runAheadConsole.runFrame(lastFrameCycles);
+    }
+
+    runAheadNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    ++runAheadCount;
+    return runAheadConsole;
+}
+
+/**
+ * Display rows that changed since the last present
+ * chip8Console tracks them itself. The run-ahead console is restored every
+ * present, which marks every row, so its frame is compared row by row
+ * against the last presented display instead.
+ */
+uint32_t App::takeDirtyRows(const Chip8 &source) {
+    uint32_t dirty = 0;
+
+    if (&source == &chip8Console) {
+        dirty = chip8Console.dirtyRows;
+        chip8Console.dirtyRows = 0;
+        //Coming back from run-ahead, presentedDisplay may differ from the console
+        if (lastSource != &chip8Console) {
+            dirty = ~0U;
+        }
+    } else {
+        for (uint32_t r = 0; r < VIDEO_HEIGHT; ++r) {
+            if (std::memcmp(presentedDisplay[r], source.display[r], VIDEO_ROW_BYTES) != 0) {
+                dirty |= 1U << r;
+            }
+        }
+        if (!lastSource) {
+            dirty = ~0U;
+        }
+    }
+
+    if (dirty) {
+        std::memcpy(presentedDisplay, source.display, sizeof(presentedDisplay));
+    }
+    lastSource = &source;
+    return dirty;
+}
+
+// Run-Ahead cost for the last report interval
+void App::reportRunAhead() {
+    if (runAheadFrames <= 0) {
+        return;
+    }
+
+    std::stringstream ss;
+    ss << "Run-Ahead : " << runAheadFrames << " frames (" << std::fixed << std::setprecision(1)
+       << runAheadFrames * 1000.0 / clock_hz << " ms less latency) | " << runAheadCount << " presents, "
+       << (runAheadCount ? runAheadNanos / 1000.0 / runAheadCount : 0.0) << " us each";
+    std::cout << ss.str() << std::endl;
+    runAheadNanos = 0;
+    runAheadCount = 0;
+}
+
+/**
+ * Emulation Thread : fixed timestep, publishes completed frames
+ * The speed multiplier shortens or stretches the timestep; above 1x only
+ * every multiplier-th frame is presented. Unlimited runs frames back to
+ * back and presents at the normal rate.
+ */
+void App::emulationLoop() {
+    using clock = std::chrono::steady_clock;
+    constexpr int MAX_CATCHUP_FRAMES = 5;
+
+    const auto presentInterval = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / clock_hz));
+    auto nextFrame = clock::now();
+    auto lastFrame = nextFrame;
+    auto lastReport = nextFrame;
+    int consecutiveSkips = 0;
+    double presentCredit = 0.;
+
+    tuneEmulationThread();
+
+    //Unchanged frames are never published, so the render thread neither uploads nor swaps
+    auto present = [this]() {
+        const Chip8 &source = runAhead();
+        uint32_t dirty = takeDirtyRows(source);
+        if (!dirty) {
+            unchangedFrames.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        ++publishSequence;
+        for (uint32_t r = 0; r < VIDEO_HEIGHT; ++r) {
+            if (dirty & (1U << r)) {
+                rowSequence[r] = publishSequence;
+            }
+        }
+
+        VideoFrame &frame = frames.writeBuffer();
+        std::memcpy(frame.display, source.display, sizeof(VideoFrame::display));
+        std::memcpy(frame.rowSequence, rowSequence, sizeof(VideoFrame::rowSequence));
+        frame.sequence = publishSequence;
+        frames.publish();
+        glfwPostEmptyEvent();   //Wake the render thread
+    };
+
+    while (emuRunning.load(std::memory_order_relaxed)) {
+        BackgroundMode background = backgroundMode();
+
+        if (background == BackgroundMode::PAUSE) {
+            std::unique_lock<std::mutex> lock(backgroundMutex);
+            backgroundChanged.wait(lock, [this]() {
+                return backgroundMode() != BackgroundMode::PAUSE || !emuRunning.load(std::memory_order_relaxed);
+            });
+            nextFrame = clock::now();   //Resume without catching up
+            continue;
+        }
+
+        if (background == BackgroundMode::LOW_POWER) {
+            //Timers and audio only : no instructions, no presents, no spinning
+            nextFrame = std::max(nextFrame + presentInterval, clock::now());
+            if (chip8Console.clock_tick()) {
+                beep();
+            }
+            std::this_thread::sleep_until(nextFrame);
+            continue;
+        }
+
+        auto currentTime = clock::now();
+        double multiplier = speedMultiplier();
+
+        if (multiplier <= 0.) {
+            //Unlimited : bounded only by the core, one present per normal frame
+            auto presentAt = currentTime + presentInterval;
+            do {
+                emulateFrame(currentTime);
+            } while (clock::now() < presentAt);
+
+            present();
+            nextFrame = clock::now();
+            lastFrame = nextFrame;
+            consecutiveSkips = 0;
+        } else {
+            const auto frameDuration = std::chrono::duration_cast<clock::duration>(presentInterval / multiplier);
+
+            //Host fell far behind (debugger, suspend) : resync instead of bursting
+            if (currentTime - nextFrame > frameDuration * MAX_CATCHUP_FRAMES) {
+                nextFrame = currentTime;
+            }
+
+            while (nextFrame <= currentTime) {
+                nextFrame += frameDuration;
+                emulateFrame(nextFrame);
+
+                //Faster than 1x : decimate presents down to the normal rate
+                presentCredit = std::min(presentCredit + 1.0 / multiplier, 1.0);
+
+                //Still behind after this frame : keep the game at full speed and drop its present
+                //Unlimited mode always runs up to the deadline, so it never counts as behind
+                bool behind = cpu_hz > 0. && clock::now() >= nextFrame;
+                if (presentCredit >= 1.0) {
+                    if (behind && consecutiveSkips < frameSkip) {
+                        ++consecutiveSkips;
+                        skippedFrames.fetch_add(1, std::memory_order_relaxed);
+                    } else {
+                        consecutiveSkips = 0;
+                        presentCredit -= 1.0;
+                        present();
+                    }
+                }
+
+                auto now = clock::now();
+                emuHistogram.record(std::chrono::duration<double, std::milli>(now - lastFrame).count());
+                lastFrame = now;
+            }
+        }
+
+        if (currentTime - lastReport >= std::chrono::seconds(5)) {
+            std::cout << emuHistogram.summary("Emulation Frame") << std::endl;
+            std::cout << emuHistogram.bars("Tick Interval");
+            std::cout << deadlineHistogram.bars("Deadline Lateness");
+            std::cout << pacer.summary() << std::endl;
+            reportRunAhead();
+            emuHistogram.clear();
+            deadlineHistogram.clear();
+            lastReport = currentTime;
+        }
+
+        if (multiplier > 0.) {
+            pacer.waitUntil(nextFrame);
+            deadlineHistogram.record(std::chrono::duration<double, std::milli>(clock::now() - nextFrame).count());
+        }
+    }
+}
+
+/**
+ * VSync Locked : each buffer swap is one display refresh
+ * Refreshes within 1% of clock_hz run exactly one emulated frame each.
+ * Other rates (75, 120, 144 Hz...) accumulate clock_hz / refresh emulated
+ * frames per refresh, using the measured refresh period.
+ */
+void App::vsyncLoop() {
+    using clock = std::chrono::steady_clock;
+    constexpr double LOCK_TOLERANCE = 0.01;
+
+    tuneEmulationThread();
+    glfwSwapInterval(1);
+
+    const GLFWvidmode *mode = glfwGetVideoMode(monitor);
+    double refreshPeriod = 1.0 / ((mode && mode->refreshRate > 0) ? mode->refreshRate : clock_hz);
+    double frameDebt = 0.;
+
+    std::stringstream ss;
     float fps = 0.0;
-    auto lastTime = std::chrono::high_resolution_clock::now();
+    auto lastTime = clock::now();
+    auto lastSwap = lastTime;
+    auto lastReport = lastTime;
+    auto nextTick = lastTime;
+    const auto tickPeriod = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / clock_hz));
 
     do {
-        auto currentTime = std::chrono::high_resolution_clock::now();
-        float time_diff = std::chrono::duration<float, std::chrono::milliseconds::period>(currentTime - lastCycleTime).count();
-        
-        chip8Console.cycle();
+        auto currentTime = clock::now();
+
+        //Background : no draws or swaps, low power ticks the timers on a sleep
+        BackgroundMode background = backgroundMode();
+        if (background != BackgroundMode::RUN) {
+            if (background == BackgroundMode::PAUSE) {
+                //Bounded, so a close from the Qt window (shouldExit) is still noticed
+                glfwWaitEventsTimeout(0.1);
+            } else {
+                for (; nextTick <= currentTime; nextTick += tickPeriod) {
+                    if (chip8Console.clock_tick()) {
+                        beep();
+                    }
+                }
+                glfwWaitEventsTimeout(std::chrono::duration<double>(nextTick - currentTime).count());
+            }
+            lastSwap = clock::now();
+            continue;
+        }
+        nextTick = currentTime;
 
+        double multiplier = speedMultiplier();
+        double ratio = clock_hz * refreshPeriod * multiplier;
+        if (std::abs(ratio - 1.0) < LOCK_TOLERANCE) {
+            ratio = 1.0;
+        }
+
+        auto deadline = currentTime + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(refreshPeriod * 0.5));
+        if (multiplier <= 0.) {
+            //Unlimited : fill half of each refresh with frames
+            do {
+                emulateFrame(currentTime);
+            } while (clock::now() < deadline);
+            frameDebt = 0.;
+        }
+
+        frameDebt += ratio;
+        for (; frameDebt >= 1.0; frameDebt -= 1.0) {
+            emulateFrame(deadline);
+        }
+
+        //Every refresh is swapped to keep the vsync clock, but only changed rows are uploaded
+        const Chip8 &source = runAhead();
+        uint32_t dirty = takeDirtyRows(source);
+        std::memcpy(vsyncFrame.display, source.display, sizeof(VideoFrame::display));
+        draw(vsyncFrame, dirty);
+        glfwSwapBuffers(window);
+        glfwPollEvents();
         ++fps;
+
+        //Track the real refresh period, ignoring stalls (window drag, occlusion)
+        auto now = clock::now();
+        double interval = std::chrono::duration<double>(now - lastSwap).count();
+        lastSwap = now;
+        renderHistogram.record(interval * 1000.0);
+        if (interval > refreshPeriod * 0.5 && interval < refreshPeriod * 1.5) {
+            refreshPeriod += (interval - refreshPeriod) * 0.05;
+        }
+
         auto time_interval = std::chrono::duration<float, std::chrono::milliseconds::period>(currentTime - lastTime).count();
 
         if (time_interval >= 1000.0f) {
-            ss << "CHIP8-Emu : " << std::fixed << std::setprecision(2) << fps << " FPS";
+            uint64_t instructions = instructionCount.exchange(0, std::memory_order_relaxed);
+            ss << "CHIP8-Emu : " << std::fixed << std::setprecision(2) << fps * 1000.0f / time_interval << " FPS | "
+               << static_cast<uint64_t>(instructions * 1000.0f / time_interval) << " IPS | VSync "
+               << 1.0 / refreshPeriod << " Hz | " << speedLabel();
             glfwSetWindowTitle(window, ss.str().c_str());
             fps = 0;
             lastTime = currentTime;
@@ -228,31 +801,103 @@ void App::mainLoop() {
             ss.clear();
         }
 
-        if (time_diff >= clock_msec) {
-            playSound = chip8Console.clock_tick();
-            if (playSound) {
-                beep();
-            }
-
-            lastCycleTime = currentTime;
+        if (currentTime - lastReport >= std::chrono::seconds(5)) {
+            reportRender("VSync Frame");
+            reportRunAhead();
+            lastReport = currentTime;
         }
 
-        // if (chip8Console.draw) {
-        draw();
-        SDL_Delay(1);
-            // chip8Console.draw = false;
-        // }
-
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-
     } while (glfwGetKey(window, GLFW_KEY_ESCAPE ) != GLFW_PRESS && 
              glfwWindowShouldClose(window) == 0 &&
              !shouldExit.load(std::memory_order_relaxed));
+
+    glfwSwapInterval(0);
 }
 
+//Main Loop : render thread, presents the newest published frame
+void App::mainLoop() {
+    using clock = std::chrono::steady_clock;
+    std::stringstream ss;
 
+    if (vsyncLocked) {
+        vsyncLoop();
+        return;
+    }
 
+    emuRunning.store(true, std::memory_order_relaxed);
+    emuThread = std::thread(&App::emulationLoop, this);
 
+    float fps = 0.0;
+    auto lastTime = clock::now();
+    auto lastPresent = lastTime;
+    auto lastReport = lastTime;
+    double lastCpu = FramePacer::processCpuSeconds();
+    uint64_t lastMisses = 0;
 
+    do {
+        auto currentTime = clock::now();
+
+        bool acquired = frames.acquire();
+        if (acquired || needsRedraw) {
+            const VideoFrame &frame = frames.readBuffer();
+
+            uint32_t dirty = 0;
+            if (acquired) {
+                for (uint32_t r = 0; r < VIDEO_HEIGHT; ++r) {
+                    if (frame.rowSequence[r] > uploadedSequence) {
+                        dirty |= 1U << r;
+                    }
+                }
+                uploadedSequence = frame.sequence;
+            }
+            needsRedraw = false;
+
+            draw(frame, dirty);
+            glfwSwapBuffers(window);
+            ++fps;
+
+            auto now = clock::now();
+            renderHistogram.record(std::chrono::duration<double, std::milli>(now - lastPresent).count());
+            lastPresent = now;
+            glfwPollEvents();
+        } else {
+            //Nothing new : block until input or the emulation thread posts a frame
+            //In the background nothing is posted; the timeout still notices shouldExit
+            glfwWaitEventsTimeout(0.1);
+        }
+
+        auto time_interval = std::chrono::duration<float, std::chrono::milliseconds::period>(currentTime - lastTime).count();
 
+        if (time_interval >= 1000.0f) {
+            uint64_t instructions = instructionCount.exchange(0, std::memory_order_relaxed);
+            double cpu = FramePacer::processCpuSeconds();
+            uint64_t misses = pacer.missCount();
+            uint64_t skipped = skippedFrames.exchange(0, std::memory_order_relaxed);
+            uint64_t unchanged = unchangedFrames.exchange(0, std::memory_order_relaxed);
+
+            ss << "CHIP8-Emu : " << std::fixed << std::setprecision(2) << fps * 1000.0f / time_interval << " FPS | "
+               << static_cast<uint64_t>(instructions * 1000.0f / time_interval) << " IPS | "
+               << std::setprecision(1) << (cpu - lastCpu) * 100000.0 / time_interval << "% CPU | "
+               << misses - lastMisses << " Missed | " << skipped << " Skipped | " << unchanged << " Unchanged | "
+               << speedLabel();
+            glfwSetWindowTitle(window, ss.str().c_str());
+            lastCpu = cpu;
+            lastMisses = misses;
+            fps = 0;
+            lastTime = currentTime;
+            ss.str("");
+            ss.clear();
+        }
+
+        if (currentTime - lastReport >= std::chrono::seconds(5)) {
+            reportRender("Render Frame");
+            lastReport = currentTime;
+        }
+
+    } while (glfwGetKey(window, GLFW_KEY_ESCAPE ) != GLFW_PRESS && 
+             glfwWindowShouldClose(window) == 0 &&
+             !shouldExit.load(std::memory_order_relaxed));
+
+    setWindowState(emuRunning, false);
+    emuThread.join();
+}
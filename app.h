@@ -8,6 +8,11 @@
 #include <cmath>
 #include <sstream>
 #include <iomanip>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
@@ -17,6 +22,12 @@
 
 #include "shader_utils.h"
 #include "chip8.h"
+#include "upscaler.h"
+#include "utils/emuSettings.h"
+#include "utils/tripleBuffer.h"
+#include "utils/frameHistogram.h"
+#include "utils/framePacer.h"
+#include "utils/threadTuning.h"
 
 // Sound
 constexpr double SAMPLING_FREQ = 44100;
@@ -26,6 +37,21 @@ constexpr int SAMPLE = 4096;
 constexpr int AUDIO_LENGTH = 1 * SND_TIME * SAMPLING_FREQ; //8-bit Audio
 constexpr double PI = 3.1415926535897;
 
+// Persistently mapped upload ring, one full display per slot
+constexpr int PIXEL_RING_SLOTS = 3;
+
+// Speed multipliers stepped through with F1 / F2, 0 = unlimited
+constexpr std::array<double, 7> SPEED_LEVELS = {0.25, 0.5, 1.0, 2.0, 4.0, 8.0, 0.0};
+constexpr int NORMAL_SPEED = 2;
+
+// Completed frame handed from the emulation thread to the render thread
+// Packed 1 bit per pixel, expanded by shaders/frag.glsl
+struct VideoFrame {
+    uint8_t display[VIDEO_HEIGHT][VIDEO_ROW_BYTES];
+    uint32_t sequence;                      //Publish number of this frame
+    uint32_t rowSequence[VIDEO_HEIGHT];     //Publish number that last changed each row
+};
+
 class App {
   private:
     GLFWwindow *window = nullptr;
@@ -50,6 +76,16 @@ class App {
     GLuint vertexBuffer = 0;
     GLuint shaderID = 0;
 
+    //Streaming Upload : GL_ARB_buffer_storage PBO ring, nullptr = upload from client memory
+    GLuint pixelBuffer = 0;
+    uint8_t *pixelRing = nullptr;
+    GLsync pixelFences[PIXEL_RING_SLOTS]{};
+    int pixelSlot = 0;
+    uint64_t pixelRingBusy = 0;                 //Uploads that found the next slot still in flight
+
+    GLfloat foreground[4] = {1.0f, 1.0f, 1.0f, 1.0f};  //Lit pixels, from the [Theme] colours
+    GLfloat background[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+
     SDL_AudioDeviceID audioDeviceID = 0;
     SDL_AudioSpec audioSpec{};
     uint32_t audioLength = AUDIO_LENGTH;
@@ -58,8 +94,13 @@ class App {
   public:
     Chip8 chip8Console;
 
-    double clock_hz = 60.;
-    double clock_msec = (1000/60.);
+    double clock_hz = 60.;     //Timer and present rate
+    double cpu_hz = 700.;      //Instruction rate, 0 = unlimited
+    bool vsyncLocked = false;  //Vertical blank drives timers and instruction budget
+    int frameSkip = 4;         //Max consecutive frames emulated but not presented
+    int runAheadFrames = 0;    //Frames presented ahead of chip8Console
+    int rtPriority = 0;        //SCHED_FIFO priority of the emulation thread, 0 = off
+    int cpuAffinity = -1;      //CPU the emulation thread is pinned to, -1 = any
 
     std::array<uint8_t, 16U> keyMapping = 
     {
@@ -69,29 +110,104 @@ class App {
         '4', 'R', 'F', 'V',
     };
 
-    App(const char *filename);
+    App(const char *filename, const EmuSettings &settings = EmuSettings());
     ~App();
 
     //OpenGL and GLFW
     void initializeGLFW();
     void setGLFWCallback();
     void setupObject();
-    void draw();
+    void setupPixelRing();
+    bool pixelSlotFree(int slot);
+    void uploadRows(const uint8_t *rows, int first, int count);
+    size_t pixelSlotBytes() const;
+    void draw(const VideoFrame &frame, uint32_t dirtyRows);
+    void reportRender(const char *name);
 
     //GLFW Callbacks
     void keyCallback(int key, int scancode, int action, int mods);
     void frameBufferResizeCallback(int width, int height);
+    void windowFocusCallback(int focused);
+    void windowIconifyCallback(int iconified);
+    void windowRefreshCallback();
 
     //SDL Sound Playback
     void initializeSDL();
     void generateSineWave(double freq, double amp);
     void beep();
 
+    //Speed Control : scales instruction budget and timer rate together
+    double speedMultiplier() const;
+    void setSpeedLevel(int level);
+    std::string speedLabel() const;
+
+    //Background Throttling
+    BackgroundMode backgroundMode() const;
+    void setWindowState(std::atomic<bool> &flag, bool value);
+
+    void emulateFrame(std::chrono::steady_clock::time_point deadline);
+    const Chip8 &runAhead();
+    uint32_t takeDirtyRows(const Chip8 &source);
+    void reportRunAhead();
+    void tuneEmulationThread();
+    void emulationLoop();
+    void vsyncLoop();
     void mainLoop();
+
+  private:
+    double cycleCarry = 0.;    //Fractional instructions carried to the next frame
+    uint32_t lastFrameCycles = 0;
+
+    //Run-Ahead : shadow machine restored from chip8Console every present
+    Chip8 runAheadConsole;
+    std::unique_ptr<Chip8::State> runAheadState;
+    uint64_t runAheadNanos = 0;
+    uint64_t runAheadCount = 0;
+
+    //Emulation Thread : owns chip8Console while running
+    std::thread emuThread;
+    std::atomic<bool> emuRunning{false};
+    std::atomic<uint16_t> keyState{0};          //Keypad bits set by the GLFW thread
+    std::atomic<bool> resetRequested{false};
+    std::atomic<uint64_t> instructionCount{0};
+    std::atomic<uint64_t> skippedFrames{0};     //Emulated but never handed to the render thread
+    std::atomic<int> speedLevel{NORMAL_SPEED};  //Index into SPEED_LEVELS
+    std::atomic<bool> turboHeld{false};         //Unlimited while TAB is held
+
+    //Window visibility, written by the GLFW thread under backgroundMutex
+    BackgroundMode minimizedMode = BackgroundMode::PAUSE;
+    BackgroundMode unfocusedMode = BackgroundMode::RUN;
+    std::atomic<bool> windowIconified{false};
+    std::atomic<bool> windowFocused{true};
+    std::mutex backgroundMutex;
+    std::condition_variable backgroundChanged;  //Wakes a paused emulation thread
+    TripleBuffer<VideoFrame> frames;
+
+    //Dirty Rows : the emulation thread stamps changed rows with the publish number,
+    //the render thread uploads rows stamped after the last frame it uploaded
+    uint32_t publishSequence = 0;
+    uint32_t rowSequence[VIDEO_HEIGHT]{};
+    uint8_t presentedDisplay[VIDEO_HEIGHT][VIDEO_ROW_BYTES]{};  //Last display handed out by takeDirtyRows()
+    const Chip8 *lastSource = nullptr;                          //Console it came from, nullptr before the first
+    uint32_t uploadedSequence = 0;
+    bool needsRedraw = false;                   //Window exposed or resized, redraw without a new frame
+    std::atomic<uint64_t> unchangedFrames{0};   //Presents skipped because no row changed
+    uint64_t uploadedRows = 0;
+    uint64_t glCalls = 0;                       //GL calls issued by draw()
+    VideoFrame vsyncFrame{};
+
+    FrameHistogram emuHistogram;                //Intervals between emulated frames (60 Hz ticks)
+    FrameHistogram deadlineHistogram{0.01};     //Wake-up lateness past each frame deadline
+    FrameHistogram renderHistogram;             //Intervals between presents
+    FramePacer pacer;                           //Sleeps the emulation thread to each frame deadline
+    Upscaler upscaler;                          //Render thread : display -> texture stage
 };
 
 //Pseudo-GLFW callbacks
 void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
 void frameBufferResizeCallback(GLFWwindow* window, int width, int height);
+void windowFocusCallback(GLFWwindow* window, int focused);
+void windowIconifyCallback(GLFWwindow* window, int iconified);
+void windowRefreshCallback(GLFWwindow* window);
 
 #endif //APP_H
\ No newline at end of file
@@ -1,18 +1,62 @@
 #include "chip8.h"
 
+#include <mutex>
+
+std::array<Chip8::f_ptr, 0x0F + 1> Chip8::opcodeTableMaster{};
+std::array<Chip8::f_ptr, 0x0F + 1> Chip8::opcodeTable0{};
+std::array<Chip8::f_ptr, 0x0F + 1> Chip8::opcodeTable8{};
+std::array<Chip8::f_ptr, 0x0F + 1> Chip8::opcodeTableE{};
+std::array<Chip8::f_ptr, 0xFF + 1> Chip8::opcodeTableF{};
+
 // Constructor
-Chip8::Chip8() : rngEngine(std::chrono::system_clock::now().time_since_epoch().count()) {
+Chip8::Chip8() {
+    static const std::shared_ptr<const MemoryImage> fontImage = makeImage(nullptr, 0);
+
     pc = START_ADDRESS;
-    loadFonts();
+    memory.attach(fontImage);
+
+    seed(static_cast<uint32_t>(std::chrono::system_clock::now().time_since_epoch().count()));
 
-    randomByte = std::uniform_int_distribution<uint32_t>(0, (std::numeric_limits<uint8_t>::max)());
-    populateFunctionPtrTable();
+    static std::once_flag tablesReady;
+    std::call_once(tablesReady, &Chip8::populateFunctionPtrTable);
 }
 
 /**
  * Load CHIP8 ROM in 0x200-0xFFF memory section (2 byte OPCODE)
  */
-void Chip8::loadROM(const char *fname) {
+bool Chip8::loadROM(const char *fname) {
+    auto image = loadImage(fname);
+
+    if (!image) {
+        return false;
+    }
+    useImage(std::move(image));
+    return true;
+}
+
+/**
+ * Load CHIP8 ROM from a byte buffer
+ */
+bool Chip8::loadROM(const uint8_t *data, size_t size) {
+    auto image = makeImage(data, size);
+
+    if (!image) {
+        return false;
+    }
+    useImage(std::move(image));
+    return true;
+}
+
+// Run from an image, possibly shared with other instances
+void Chip8::useImage(std::shared_ptr<const MemoryImage> image) {
+    memory.attach(std::move(image));
+}
+
+/**
+ * Read a ROM file into a new image, nullptr on failure
+ * Load once and pass to useImage() to share one copy between instances
+ */
+std::shared_ptr<const MemoryImage> Chip8::loadImage(const char *fname) {
     std::cout << "Loading ROM : " << fname << std::endl;
     std::ifstream file(fname, std::ios::binary);
 
@@ -22,26 +66,41 @@ void Chip8::loadROM(const char *fname) {
         if (size > (END_ADDRESS - START_ADDRESS)) {
             std::cout << "ERROR : File size too big " << fname << std::endl;
             file.close();
-            return;
+            return nullptr;
         }
 
-        BUFFER.resize(size);
-
-        file.read(BUFFER.data(), size);
+        std::string data(size, '\0');
+        file.read(data.data(), size);
         std::cout << "ROM Size : " << size << " bytes" << std::endl;
 
-        std::memcpy(&memory[START_ADDRESS], BUFFER.data(), size);
         file.close();
-    } else {
-        std::cout << "ERROR : Cannot load ROM " << fname << std::endl;
+        return makeImage(reinterpret_cast<const uint8_t *>(data.data()), size);
+    }
+
+    std::cout << "ERROR : Cannot load ROM " << fname << std::endl;
+    return nullptr;
+}
+
+// Fonts + ROM bytes at START_ADDRESS
+std::shared_ptr<const MemoryImage> Chip8::makeImage(const uint8_t *data, size_t size) {
+    if (size > (END_ADDRESS - START_ADDRESS)) {
+        return nullptr;
+    }
+
+    auto image = std::make_shared<MemoryImage>();
+    loadFonts(*image);
+    if (size) {
+        std::memcpy(&image->bytes[START_ADDRESS], data, size);
     }
+    image->romSize = size;
+    return image;
 }
 
 
 /**
  * Loads Fonts into Memory [0x050-0x0A0]
  */
-void Chip8::loadFonts() {
+void Chip8::loadFonts(MemoryImage &image) {
     constexpr uint32_t FONT_SZ = 16 * 5;
 
     uint8_t fonts[FONT_SZ] = {
@@ -64,14 +123,20 @@ void Chip8::loadFonts() {
     };
 
     for (int i = 0; i < FONT_SZ; ++i) {
-        memory[FONT_START_ADDRESS + i] = fonts[i];
+        image.bytes[FONT_START_ADDRESS + i] = fonts[i];
     }
 }
 
 // Execute the Fetch, Decode, Execute cycle
 void Chip8::cycle() {
+    // Edge Coverage (prev pc -> pc)
+    if (coverageMap) {
+        ++coverageMap[((lastPc * 0x9E37U) ^ pc) & (COVERAGE_MAP_SIZE - 1)];
+        lastPc = pc;
+    }
+
     // Fetch
-    opcode = ((uint16_t)memory[pc] << 8U) | (memory[pc + 1]);
+    opcode = ((uint16_t)memory.read(pc & END_ADDRESS) << 8U) | memory.read((pc + 1) & END_ADDRESS);
     // printRed(opcode);
 
     Vx = (opcode & 0x0F00U) >> 0x08U;  //_X__
@@ -103,21 +168,106 @@ bool Chip8::clock_tick() {
     return false;
 }
 
+// Run one 60 Hz frame : N instructions then a timer tick, returns true on beep
+bool Chip8::runFrame(uint32_t instructions) {
+    for (uint32_t i = 0; i < instructions; ++i) {
+        cycle();
+    }
+    return clock_tick();
+}
+
+// Seed the RNG used by OP_CXKK (xorshift32 cannot hold 0)
+void Chip8::seed(uint32_t value) {
+    rngState = value ? value : 0x9E3779B9U;
+}
+
+uint8_t Chip8::randomByte() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return static_cast<uint8_t>(rngState >> 24);
+}
+
+// Copy the machine state out, no allocation. Only private memory pages are copied.
+void Chip8::clone(State &out) const {
+    std::memcpy(out.registers, registers, sizeof(registers));
+
+    out.privatePages = memory.privatePages();
+    for (uint32_t p = 0; p < MEMORY_PAGES; ++p) {
+        if (out.privatePages & (1U << p)) {
+            std::memcpy(&out.memory[p * MEMORY_PAGE_SIZE], memory.page(p), MEMORY_PAGE_SIZE);
+        }
+    }
+
+    out.index = index;
+    out.pc = pc;
+    std::memcpy(out.stack, stack, sizeof(stack));
+    out.sp = sp;
+    out.delay_timer = delay_timer;
+    out.sound_timer = sound_timer;
+    out.draw = draw;
+    out.faults = faults;
+    out.rngState = rngState;
+    std::memcpy(out.keypad, keypad, sizeof(keypad));
+    std::memcpy(out.display, display, sizeof(display));
+}
+
+// Restore a state taken from an instance running the same ROM
+void Chip8::restore(const State &in) {
+    std::memcpy(registers, in.registers, sizeof(registers));
+
+    for (uint32_t p = 0; p < MEMORY_PAGES; ++p) {
+        if (in.privatePages & (1U << p)) {
+            std::memcpy(memory.privatePage(p, false), &in.memory[p * MEMORY_PAGE_SIZE], MEMORY_PAGE_SIZE);
+        } else if (memory.privatePages() & (1U << p)) {
+            memory.sharePage(p);
+        }
+    }
+
+    index = in.index;
+    pc = in.pc;
+    std::memcpy(stack, in.stack, sizeof(stack));
+    sp = in.sp;
+    delay_timer = in.delay_timer;
+    sound_timer = in.sound_timer;
+    draw = in.draw;
+    faults = in.faults;
+    rngState = in.rngState;
+    std::memcpy(keypad, in.keypad, sizeof(keypad));
+    std::memcpy(display, in.display, sizeof(display));
+    dirtyRows = ~0U;
+}
+
+// Write bytes into a saved state, pulling untouched pages in from the ROM image
+void Chip8::patch(State &state, uint16_t address, const uint8_t *data, size_t size) const {
+    for (size_t i = 0; i < size; ++i) {
+        uint32_t target = (address + i) & END_ADDRESS;
+        uint32_t p = target / MEMORY_PAGE_SIZE;
+
+        if (!(state.privatePages & (1U << p))) {
+            std::memcpy(&state.memory[p * MEMORY_PAGE_SIZE], &memoryImage().bytes[p * MEMORY_PAGE_SIZE], MEMORY_PAGE_SIZE);
+            state.privatePages |= 1U << p;
+        }
+        state.memory[target] = data[i];
+    }
+}
+
 // Reset
 void Chip8::reset() {
     std::memset(registers, 0, sizeof(registers));
-    std::memset(memory, 0, sizeof(memory));
-    loadFonts();
-    std::memcpy(&memory[START_ADDRESS], BUFFER.data(), BUFFER.size());
+    memory.attach(memory.sharedImage());
     index = 0;
     std::memset(stack, 0, sizeof(stack));
     sp = 0;
     delay_timer = 0;
     sound_timer = 0;
     std::memset(keypad, 0, sizeof(keypad));
-    std::memset(video_frame, 0, sizeof(video_frame));
+    std::memset(display, 0, sizeof(display));
+    dirtyRows = ~0U;
     opcode = 0;
     draw = true;
+    faults = FAULT_NONE;
+    lastPc = 0;
     pc = START_ADDRESS;
 }
 
@@ -125,12 +275,17 @@ void Chip8::reset() {
 
 // Clear the Display
 void Chip8::OP_00E0() {
-    std::memset(video_frame, 0, sizeof(video_frame));
+    std::memset(display, 0, sizeof(display));
+    dirtyRows = ~0U;
     draw = true;
 }
 
 // Return from a subroutine
 void Chip8::OP_00EE() {
+    if (sp == 0) {
+        faults |= FAULT_STACK_UNDERFLOW;
+        return;
+    }
     --sp;
     pc = stack[sp];
 }
@@ -142,6 +297,10 @@ void Chip8::OP_1NNN() {
 
 // Call Address
 void Chip8::OP_2NNN() {
+    if (sp >= 16) {
+        faults |= FAULT_STACK_OVERFLOW;
+        return;
+    }
     stack[sp++] = pc;
     pc = addr;
 }
@@ -248,46 +407,56 @@ void Chip8::OP_BNNN() {
 
 // Set Vx = RND AND KK
 void Chip8::OP_CXKK() {
-    registers[Vx] = static_cast<uint8_t>(randomByte(rngEngine)) & val;
+    registers[Vx] = randomByte() & val;
 }
 
 /**
  * Draw at position Vx, Vy
  * Read from Memory[i] (N bytes)
  * 8-Bit-Encoded Sprites of height N, col=8
+ * Each sprite row lands in at most two display bytes, wrapping at the edges
  */
 void Chip8::OP_DXYN() {
     registers[0x0F] = 0;
     uint8_t x_pos = registers[Vx] % VIDEO_WIDTH;
     uint8_t y_pos = registers[Vy] % VIDEO_HEIGHT;
 
+    uint32_t left = x_pos / 8;
+    uint32_t right = (left + 1) % VIDEO_ROW_BYTES;
+    uint32_t shift = x_pos % 8;
+
     for (int r = 0; r < height; ++r) {
-        uint8_t sprite_row = memory[index + r];
-        for (int c = 0; c < 8; ++c) {
-            uint8_t sprite_pixel = sprite_row & (0x80U >> c);
-            uint32_t *pixel = &video_frame[(y_pos + r) % VIDEO_HEIGHT][(x_pos + c) % VIDEO_WIDTH];
-
-            if (sprite_pixel) {
-                if (*pixel) {
-                    registers[0x0F] = 1;
-                }
-                *pixel ^= 0xFFFFFFFF;
-            }
+        uint8_t sprite_row = memory.read((index + r) & END_ADDRESS);
+        if (!sprite_row) {
+            continue;
+        }
+
+        uint32_t y = (y_pos + r) % VIDEO_HEIGHT;
+        uint8_t *row = display[y];
+        dirtyRows |= 1U << y;
+
+        uint8_t high = sprite_row >> shift;
+        uint8_t low = shift ? static_cast<uint8_t>(sprite_row << (8 - shift)) : 0;
+
+        if ((row[left] & high) | (row[right] & low)) {
+            registers[0x0F] = 1;
         }
+        row[left] ^= high;
+        row[right] ^= low;
     }
     draw = true;
 }
 
 // Skip Instruction if Key with val(Vx) is pressed
 void Chip8::OP_EX9E() {
-    if (keypad[registers[Vx]]) {
+    if (keypad[registers[Vx] & 0x0FU]) {
         pc += 0x02U;
     }
 }
 
 // Skip Instruction if key with val(Vx) is not pressed
 void Chip8::OP_EXA1() {
-    if (!keypad[registers[Vx]]) {
+    if (!keypad[registers[Vx] & 0x0FU]) {
         pc += 0x02U;
     }
 }
@@ -299,8 +468,6 @@ void Chip8::OP_FX07() {
 
 // Wait for keypress - store in Vx
 void Chip8::OP_FX0A() {
-    std::cout << "Waiting for Keypress...\n";
-
     for (int i = 0; i < 16; ++i) {
         if (keypad[i]) {
             registers[Vx] = i;
@@ -334,24 +501,29 @@ void Chip8::OP_FX29() {
 // Store BCD representation of Vx in I, I+1, I+2
 void Chip8::OP_FX33() {
     uint8_t val = registers[Vx];
+    checkBounds(index + 2);
 
     for (int i = 0; i < 3; ++i) {
-        memory[index + 2 - i] = val % 10;
+        memory.write((index + 2 - i) & END_ADDRESS, val % 10);
         val /= 10;
     }
 }
 
 // Store [V0-Vx] in memory[I]
 void Chip8::OP_FX55() {
+    checkBounds(index + Vx);
+
     for (int i = 0; i <= Vx; ++i) {
-        memory[index + i] = registers[i];
+        memory.write((index + i) & END_ADDRESS, registers[i]);
     }
 }
 
 // Load [V0-Vx] from memory[I]
 void Chip8::OP_FX65() {
+    checkBounds(index + Vx);
+
     for (int i = 0; i <= Vx; ++i) {
-        registers[i] = memory[index + i];
+        registers[i] = memory.read((index + i) & END_ADDRESS);
     }
 }
 
@@ -413,7 +585,11 @@ void Chip8::populateFunctionPtrTable() {
     opcodeTableF[0x65] = &Chip8::OP_FX65;
 }
 
+// 00E0 / 00EE, any other 0NNN (SYS addr) is ignored
 void Chip8::decodeOpcode0() {
+    if ((opcode & 0xFFF0U) != 0x00E0U) {
+        return;
+    }
     std::invoke(opcodeTable0[opcode & 0x000FU], this);
 }
 
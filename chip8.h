@@ -5,24 +5,61 @@
 #include <string>
 #include <cassert>
 #include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <filesystem>
 #include <chrono>
-#include <random>
 #include <limits>
 #include <functional>
 #include <array>
+#include <memory>
+
+#include "paged_memory.h"
 
 constexpr uint32_t START_ADDRESS = 0x200;
 constexpr uint32_t END_ADDRESS = 0xFFF;
 constexpr uint32_t FONT_START_ADDRESS = 0x050;
 constexpr uint32_t VIDEO_WIDTH = 64U;
 constexpr uint32_t VIDEO_HEIGHT = 32U;
+constexpr uint32_t VIDEO_ROW_BYTES = VIDEO_WIDTH / 8;   //1 bit per pixel, MSB = leftmost
+constexpr uint32_t COVERAGE_MAP_SIZE = 1U << 13;
+
+// Faults latched by the core instead of corrupting state
+enum Chip8Fault : uint8_t {
+    FAULT_NONE = 0,
+    FAULT_STACK_OVERFLOW = 1 << 0,
+    FAULT_STACK_UNDERFLOW = 1 << 1,
+    FAULT_MEMORY_BOUNDS = 1 << 2,   // I + offset past 0xFFF, wrapped
+};
 
 class Chip8 {
+   public:
+    /**
+     * Machine state captured by clone()/restore(). The ROM image is not part of it.
+     * memory[] has room for every page (4 KB of the ~4.4 KB total), but clone()
+     * and restore() only copy the privatePages, so their cost follows the
+     * pages the ROM has written plus ~340 bytes of registers and display.
+     */
+    struct State {
+        uint8_t registers[16];
+        uint16_t privatePages;          // Only these pages of memory[] are stored,
+        uint8_t memory[MEMORY_SIZE];    // the rest match the ROM image
+        uint16_t index;
+        uint16_t pc;
+        uint16_t stack[16];
+        uint8_t sp;
+        uint8_t delay_timer;
+        uint8_t sound_timer;
+        bool draw;
+        uint8_t faults;
+        uint32_t rngState;
+        uint8_t keypad[16];
+        uint8_t display[VIDEO_HEIGHT][VIDEO_ROW_BYTES];
+    };
+
    private:
     uint8_t registers[16]{};    //Register V0...VF
-    uint8_t memory[4096]{};
+    PagedMemory memory;         //Copy-on-write over the shared ROM image
     uint16_t index{};           //Store Address during operations
     uint16_t pc{};              //Program Counter
     uint16_t stack[16]{};
@@ -37,33 +74,84 @@ class Chip8 {
     uint8_t val;                //__KK
     uint8_t height;             //___N
 
-    //Random Number Generator
-    std::default_random_engine rngEngine;
-    std::uniform_int_distribution<uint32_t> randomByte;
+    uint8_t faults = FAULT_NONE;
 
-    //Function Pointer Table
-    using f_ptr = void (Chip8::*)();
+    //Edge Coverage (optional, for fuzzing)
+    uint8_t *coverageMap = nullptr;
+    uint16_t lastPc = 0;
 
-    std::array<f_ptr, 0x0F + 1> opcodeTableMaster{};
-    std::array<f_ptr, 0x0E + 1> opcodeTable0{};
-    std::array<f_ptr, 0x0E + 1> opcodeTable8{};
-    std::array<f_ptr, 0x0E + 1> opcodeTableE{};
-    std::array<f_ptr, 0x65 + 1> opcodeTableF{};
+    //Random Number Generator (xorshift32)
+    uint32_t rngState;
 
-    std::string BUFFER;
+    //Function Pointer Table (shared by all instances)
+    using f_ptr = void (Chip8::*)();
+
+    static std::array<f_ptr, 0x0F + 1> opcodeTableMaster;
+    static std::array<f_ptr, 0x0F + 1> opcodeTable0;
+    static std::array<f_ptr, 0x0F + 1> opcodeTable8;
+    static std::array<f_ptr, 0x0F + 1> opcodeTableE;
+    static std::array<f_ptr, 0xFF + 1> opcodeTableF;
 
    public:
     uint8_t keypad[16]{};
-    uint32_t video_frame[VIDEO_HEIGHT][VIDEO_WIDTH]{};
+    uint8_t display[VIDEO_HEIGHT][VIDEO_ROW_BYTES]{};    //Packed framebuffer, 256 bytes
     bool draw = true;
+    uint32_t dirtyRows = ~0U;   //Display rows changed since the consumer last cleared it, bit r = row r
 
     Chip8();
 
-    void loadROM(const char *);
-    void loadFonts();
+    bool loadROM(const char *);
+    bool loadROM(const uint8_t *data, size_t size);
+    void useImage(std::shared_ptr<const MemoryImage> image);
+
+    static std::shared_ptr<const MemoryImage> loadImage(const char *fname);
+    static std::shared_ptr<const MemoryImage> makeImage(const uint8_t *data, size_t size);
+    static void loadFonts(MemoryImage &image);
+
     void cycle();
     bool clock_tick();
+    bool runFrame(uint32_t instructions);
     void reset();
+    void seed(uint32_t value);
+
+    void clone(State &out) const;
+    void restore(const State &in);
+    void patch(State &state, uint16_t address, const uint8_t *data, size_t size) const;
+
+    uint8_t peek(uint16_t address) const {
+        return memory.read(address & END_ADDRESS);
+    }
+
+    const MemoryImage &memoryImage() const {
+        return *memory.sharedImage();
+    }
+
+    const std::shared_ptr<const MemoryImage> &sharedImage() const noexcept {
+        return memory.sharedImage();
+    }
+
+    uint16_t privatePages() const noexcept {
+        return memory.privatePages();
+    }
+
+    // Take private memory pages from slab (nullptr = process-wide slab)
+    void usePageSlab(PageSlab *slab) {
+        memory.useSlab(slab);
+    }
+
+    uint16_t getPC() const noexcept {
+        return pc;
+    }
+
+    uint8_t getFaults() const noexcept {
+        return faults;
+    }
+
+    // Count (pc, next pc) edges into a COVERAGE_MAP_SIZE byte map, nullptr disables
+    void setCoverageMap(uint8_t *map) noexcept {
+        coverageMap = map;
+        lastPc = pc;
+    }
 
    private:
     //OPCODES
@@ -103,7 +191,15 @@ class Chip8 {
     void OP_FX65();  //LD Vx, I
     void OP_NULL();  //NOP
 
-    void populateFunctionPtrTable();
+    uint8_t randomByte();
+
+    void checkBounds(uint32_t last) {
+        if (last > END_ADDRESS) {
+            faults |= FAULT_MEMORY_BOUNDS;
+        }
+    }
+
+    static void populateFunctionPtrTable();
     void decodeOpcode0();
     void decodeOpcode8();
     void decodeOpcodeE();
@@ -111,4 +207,6 @@ class Chip8 {
 
 };
 
+static_assert(sizeof(Chip8::State) <= MEMORY_SIZE + 352, "State is full memory plus at most 352 bytes of registers and display");
+
 #endif // CHIP8_H
\ No newline at end of file
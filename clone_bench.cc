@@ -0,0 +1,92 @@
+/**
+ * Snapshot benchmark
+ * chip8clone_bench [rom] : clone(), restore() and a full machine copy, in ns
+ * The machine is run for a few seconds of game time first, so its private
+ * pages are those a real search or rollout would snapshot.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <memory>
+#include <bitset>
+
+#include "chip8.h"
+
+// Average ns per call of fn over ~0.5 s
+template <typename Fn>
+static double timeNs(Fn &&fn) {
+    using clock = std::chrono::steady_clock;
+    uint64_t calls = 0;
+    auto start = clock::now();
+    auto elapsed = std::chrono::duration<double>(0);
+    do {
+        for (int i = 0; i < 1000; ++i) {
+            fn();
+        }
+        calls += 1000;
+        elapsed = clock::now() - start;
+    } while (elapsed.count() < 0.5);
+    return elapsed.count() * 1e9 / calls;
+}
+
+int main(int argc, char *argv[]) {
+    Chip8 chip8;
+    if (!chip8.loadROM(argc > 1 ? argv[1] : "rom/Space Invaders [David Winter].ch8")) {
+        return 1;
+    }
+    chip8.seed(1);
+    for (int f = 0; f < 300; ++f) {
+        chip8.runFrame(12);
+    }
+
+    auto state = std::make_unique<Chip8::State>();
+    auto other = std::make_unique<Chip8>();
+    other->useImage(chip8.sharedImage());
+
+    //Sinks so the copies are not optimised away
+    volatile uint8_t sink = 0;
+
+    double clone = timeNs([&]() {
+        chip8.clone(*state);
+        sink = state->pc & 0xFF;
+    });
+    double restore = timeNs([&]() {
+        other->restore(*state);
+        sink = other->peek(0x200);
+    });
+    double copy = timeNs([&]() {
+        *other = chip8;
+        sink = other->peek(0x200);
+    });
+
+    //Worst case : every page written (patched with its own bytes, so behaviour is unchanged)
+    Chip8 worst = chip8;
+    worst.clone(*state);
+    for (uint32_t p = 0; p < MEMORY_PAGES; ++p) {
+        uint8_t byte = worst.peek(static_cast<uint16_t>(p * MEMORY_PAGE_SIZE));
+        worst.patch(*state, static_cast<uint16_t>(p * MEMORY_PAGE_SIZE), &byte, 1);
+    }
+    worst.restore(*state);
+
+    double worstClone = timeNs([&]() {
+        worst.clone(*state);
+        sink = state->pc & 0xFF;
+    });
+    double worstRestore = timeNs([&]() {
+        other->restore(*state);
+        sink = other->peek(0x200);
+    });
+
+    std::cout << "Private Pages : " << std::bitset<MEMORY_PAGES>(chip8.privatePages()).count() << " of " << MEMORY_PAGES
+              << " | State " << sizeof(Chip8::State) << " bytes | Chip8 " << sizeof(Chip8) << " bytes" << std::endl;
+    std::cout << std::fixed << std::setprecision(1)
+              << "clone()         " << std::setw(8) << clone << " ns" << std::endl
+              << "restore()       " << std::setw(8) << restore << " ns" << std::endl
+              << "clone+restore   " << std::setw(8) << clone + restore << " ns" << std::endl
+              << "Chip8 copy      " << std::setw(8) << copy << " ns" << std::endl
+              << "All 16 pages private :" << std::endl
+              << "clone()         " << std::setw(8) << worstClone << " ns" << std::endl
+              << "restore()       " << std::setw(8) << worstRestore << " ns" << std::endl;
+    return 0;
+}
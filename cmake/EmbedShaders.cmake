@@ -0,0 +1,27 @@
+# Embeds every shader in SHADER_DIR into OUTPUT as raw string literals
+# cmake -DSHADER_DIR=<dir> -DOUTPUT=<header> -P EmbedShaders.cmake
+# The result is looked up by file name with embeddedShader() (shader_utils.h)
+
+file(GLOB shaders "${SHADER_DIR}/*.glsl")
+list(SORT shaders)
+
+set(content "// Generated from shaders/ by cmake/EmbedShaders.cmake, do not edit\n")
+string(APPEND content "#ifndef EMBEDDED_SHADERS_H\n#define EMBEDDED_SHADERS_H\n\n")
+string(APPEND content "struct EmbeddedShader {\n    const char *name;\n    const char *source;\n};\n\n")
+string(APPEND content "static const EmbeddedShader EMBEDDED_SHADERS[] = {\n")
+
+foreach(shader ${shaders})
+    get_filename_component(name "${shader}" NAME)
+    file(READ "${shader}" source)
+    string(APPEND content "    {\"${name}\", R\"glsl(${source})glsl\"},\n")
+endforeach()
+
+string(APPEND content "};\n\n#endif // EMBEDDED_SHADERS_H\n")
+
+# Leave the header untouched when nothing changed, so dependents do not rebuild
+if (EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" previous)
+endif()
+if (NOT "${previous}" STREQUAL "${content}")
+    file(WRITE "${OUTPUT}" "${content}")
+endif()
@@ -0,0 +1,49 @@
+/**
+ * Fuzzer throughput benchmark
+ * chip8fuzz_bench [rom] [executions per thread] : executions per second
+ * with one thread and with every hardware thread, then the faults found
+ */
+
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+
+#include "rom_fuzzer.h"
+
+int main(int argc, char *argv[]) {
+    const char *path = argc > 1 ? argv[1] : "rom/Space Invaders [David Winter].ch8";
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8_t> rom((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (rom.empty()) {
+        std::cerr << "Failed to load ROM : " << path << std::endl;
+        return 1;
+    }
+
+    FuzzerConfig config;
+    config.executions = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20000;
+
+    const size_t hardware = std::max(1U, std::thread::hardware_concurrency());
+    FuzzReport report;
+
+    for (size_t threads : {size_t(1), hardware}) {
+        config.numThreads = threads;
+        report = RomFuzzer(config).run(rom);
+
+        std::cout << "Threads : " << threads << " | " << config.executions << " executions of "
+                  << config.framesPerExec << " frames each" << std::endl;
+        report.print(std::cout);
+
+        if (threads == hardware) {
+            break;
+        }
+    }
+
+    for (const auto &crash : report.crashes) {
+        std::cout << "Fault " << int(crash.first) << " : " << crash.second.script.size() << " input events" << std::endl;
+    }
+    return 0;
+}
@@ -47,8 +47,8 @@ GUI_MainWindow::GUI_MainWindow(const char *argv0, QMainWindow *parent) : QMainWi
     }
 }
 
-void runChip8Emu(std::string filename) {
-    App app(filename.c_str());
+void runChip8Emu(std::string filename, EmuSettings settings) {
+    App app(filename.c_str(), settings);
     app.mainLoop();
     isRunning.store(false, std::memory_order_seq_cst);
     return;
@@ -63,7 +63,7 @@ void GUI_MainWindow::actionTestch8_clicked() {
         isRunning.store(true, std::memory_order_seq_cst);
         shouldExit.store(false, std::memory_order_relaxed);
         //TODO: check valid rom
-        std::thread t(runChip8Emu, config->getRecentROM(id));  //"./rom/Pong (1 player).ch8"
+        std::thread t(runChip8Emu, config->getRecentROM(id), config->getSettings());  //"./rom/Pong (1 player).ch8"
         t.detach();
     }
 }
@@ -0,0 +1,110 @@
+#include "machine_pool.h"
+
+#include <new>
+#include <algorithm>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+MachinePool::MachinePool(size_t count, size_t pagesPerMachine) : capacity(count) {
+    constexpr size_t CACHE_LINE = 64;
+    stride = (sizeof(Chip8) + CACHE_LINE - 1) & ~(CACHE_LINE - 1);
+
+    //Machines, then their memory pages
+    size_t slabOffset = (stride * capacity + MEMORY_PAGE_SIZE - 1) & ~size_t(MEMORY_PAGE_SIZE - 1);
+    size_t slabPages = capacity * pagesPerMachine;
+    size_t bytes = std::max<size_t>(slabOffset + slabPages * MEMORY_PAGE_SIZE, 1);
+    allocateArena((bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1));
+
+    pages = std::make_unique<PageSlab>(arena + slabOffset, slabPages);
+
+    freeList.reserve(capacity);
+    for (size_t i = 0; i < capacity; ++i) {
+        Chip8 *machine = new (arena + i * stride) Chip8();
+        machine->usePageSlab(pages.get());
+        freeList.push_back(static_cast<uint32_t>(capacity - 1 - i));
+    }
+}
+
+// Machines hand their pages back to the slab, so they go first
+MachinePool::~MachinePool() {
+    for (size_t i = 0; i < capacity; ++i) {
+        at(i)->~Chip8();
+    }
+    pages.reset();
+    releaseArena();
+}
+
+// Huge pages first, then regular pages
+void MachinePool::allocateArena(size_t bytes) {
+    arenaBytes = bytes;
+
+#if defined(_WIN32)
+    SIZE_T large = GetLargePageMinimum();
+    if (large && bytes % large == 0) {
+        arena = static_cast<uint8_t *>(VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE));
+        backing = PageBacking::HUGE_TLB;
+    }
+    if (!arena) {
+        arena = static_cast<uint8_t *>(VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+        backing = PageBacking::REGULAR;
+    }
+#else
+#ifdef MAP_HUGETLB
+    void *ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (ptr != MAP_FAILED) {
+        arena = static_cast<uint8_t *>(ptr);
+        backing = PageBacking::HUGE_TLB;
+    }
+#endif
+    if (!arena) {
+        void *ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr != MAP_FAILED) {
+            arena = static_cast<uint8_t *>(ptr);
+            backing = PageBacking::REGULAR;
+#ifdef MADV_HUGEPAGE
+            if (madvise(ptr, bytes, MADV_HUGEPAGE) == 0) {
+                backing = PageBacking::TRANSPARENT_HUGE;
+            }
+#endif
+        }
+    }
+#endif
+
+    if (!arena) {
+        throw std::bad_alloc();
+    }
+}
+
+void MachinePool::releaseArena() {
+#if defined(_WIN32)
+    VirtualFree(arena, 0, MEM_RELEASE);
+#else
+    munmap(arena, arenaBytes);
+#endif
+    arena = nullptr;
+}
+
+Chip8 *MachinePool::borrow() {
+    std::lock_guard<std::mutex> lock(mtx);
+
+    if (freeList.empty()) {
+        return nullptr;
+    }
+    uint32_t idx = freeList.back();
+    freeList.pop_back();
+    return at(idx);
+}
+
+// Instances are returned as-is, the borrower resets what it needs
+void MachinePool::giveBack(Chip8 *machine) {
+    size_t idx = (reinterpret_cast<uint8_t *>(machine) - arena) / stride;
+
+    std::lock_guard<std::mutex> lock(mtx);
+    freeList.push_back(static_cast<uint32_t>(idx));
+}
@@ -0,0 +1,67 @@
+#ifndef MACHINE_POOL_H
+#define MACHINE_POOL_H
+
+#include <vector>
+#include <mutex>
+#include <memory>
+
+#include "chip8.h"
+
+constexpr size_t HUGE_PAGE_SIZE = 2U << 20;
+
+enum class PageBacking {
+    HUGE_TLB,           // Explicit 2 MB pages (MAP_HUGETLB / MEM_LARGE_PAGES)
+    TRANSPARENT_HUGE,   // Regular mapping with MADV_HUGEPAGE
+    REGULAR,
+};
+
+/**
+ * Fixed-capacity pool of Chip8 instances laid out contiguously in one arena
+ * All instances are constructed up front; borrow()/giveBack() never allocate
+ * Private memory pages come from a slab in the arena tail, sized for
+ * pagesPerMachine written pages per instance before it grows
+ */
+class MachinePool {
+   private:
+    uint8_t *arena = nullptr;
+    size_t arenaBytes = 0;
+    size_t stride = 0;
+    size_t capacity = 0;
+    PageBacking backing = PageBacking::REGULAR;
+    std::unique_ptr<PageSlab> pages;
+
+    std::mutex mtx;
+    std::vector<uint32_t> freeList;
+
+    void allocateArena(size_t bytes);
+    void releaseArena();
+
+   public:
+    explicit MachinePool(size_t count, size_t pagesPerMachine = 4);
+    ~MachinePool();
+
+    MachinePool(const MachinePool &) = delete;
+    MachinePool &operator=(const MachinePool &) = delete;
+
+    // nullptr when the pool is exhausted
+    Chip8 *borrow();
+    void giveBack(Chip8 *machine);
+
+    Chip8 *at(size_t idx) const {
+        return reinterpret_cast<Chip8 *>(arena + idx * stride);
+    }
+
+    size_t size() const noexcept {
+        return capacity;
+    }
+
+    PageBacking pageBacking() const noexcept {
+        return backing;
+    }
+
+    PageSlab &pageSlab() const noexcept {
+        return *pages;
+    }
+};
+
+#endif // MACHINE_POOL_H
@@ -0,0 +1,135 @@
+#include "paged_memory.h"
+
+// Page Slab
+
+PageSlab::PageSlab(uint8_t *memory, size_t pages) {
+    add(memory, pages);
+}
+
+void PageSlab::add(uint8_t *memory, size_t pages) {
+    totalPages += pages;
+    freeList.reserve(totalPages);
+    for (size_t i = pages; i-- > 0;) {
+        freeList.push_back(memory + i * MEMORY_PAGE_SIZE);
+    }
+}
+
+uint8_t *PageSlab::acquire() {
+    std::lock_guard<std::mutex> lock(mtx);
+
+    if (freeList.empty()) {
+        chunks.emplace_back(new Page[CHUNK_PAGES]);
+        add(chunks.back()[0].bytes, CHUNK_PAGES);
+    }
+    uint8_t *page = freeList.back();
+    freeList.pop_back();
+    return page;
+}
+
+void PageSlab::release(uint8_t *page) {
+    std::lock_guard<std::mutex> lock(mtx);
+    freeList.push_back(page);
+}
+
+PageSlab &PageSlab::shared() {
+    static PageSlab *slab = new PageSlab();
+    return *slab;
+}
+
+// Paged Memory
+
+PagedMemory::PagedMemory(const PagedMemory &other) : slab(other.slab) {
+    *this = other;
+}
+
+// Private pages are deep-copied, the image stays shared; the slab is not copied
+PagedMemory &PagedMemory::operator=(const PagedMemory &other) {
+    if (this == &other) {
+        return *this;
+    }
+
+    attach(other.image);
+    for (uint32_t p = 0; p < MEMORY_PAGES; ++p) {
+        if (other.privateMask & (1U << p)) {
+            std::memcpy(privatePage(p, false), other.pages[p], MEMORY_PAGE_SIZE);
+        }
+    }
+    return *this;
+}
+
+PagedMemory::~PagedMemory() {
+    releasePages();
+}
+
+void PagedMemory::releasePages() {
+    PageSlab &source = pageSource();
+    for (uint32_t p = 0; p < MEMORY_PAGES; ++p) {
+        if (privateStore[p]) {
+            source.release(privateStore[p]);
+            privateStore[p] = nullptr;
+        }
+    }
+}
+
+void PagedMemory::useSlab(PageSlab *source) {
+    if (source == slab) {
+        return;
+    }
+
+    //Private pages keep their bytes, unused pages go back
+    uint8_t saved[MEMORY_PAGES][MEMORY_PAGE_SIZE];
+    uint16_t mask = privateMask;
+    for (uint32_t p = 0; p < MEMORY_PAGES; ++p) {
+        if (mask & (1U << p)) {
+            std::memcpy(saved[p], privateStore[p], MEMORY_PAGE_SIZE);
+        }
+    }
+
+    releasePages();
+    privateMask = 0;
+    slab = source;
+
+    for (uint32_t p = 0; p < MEMORY_PAGES; ++p) {
+        if (mask & (1U << p)) {
+            std::memcpy(privatePage(p, false), saved[p], MEMORY_PAGE_SIZE);
+        }
+    }
+}
+
+void PagedMemory::attach(std::shared_ptr<const MemoryImage> img) {
+    image = std::move(img);
+    privateMask = 0;
+
+    for (uint32_t p = 0; p < MEMORY_PAGES; ++p) {
+        pages[p] = image ? &image->bytes[p * MEMORY_PAGE_SIZE] : nullptr;
+    }
+}
+
+uint8_t *PagedMemory::privatePage(uint32_t p, bool preserve) {
+    if (!privateStore[p]) {
+        privateStore[p] = pageSource().acquire();
+    }
+
+    uint8_t *dest = privateStore[p];
+    if (!(privateMask & (1U << p))) {
+        if (preserve) {
+            std::memcpy(dest, pages[p], MEMORY_PAGE_SIZE);
+        }
+        pages[p] = dest;
+        privateMask |= 1U << p;
+    }
+    return dest;
+}
+
+void PagedMemory::sharePage(uint32_t p) {
+    pages[p] = &image->bytes[p * MEMORY_PAGE_SIZE];
+    privateMask &= ~(1U << p);
+}
+
+uint32_t PagedMemory::heldPages() const noexcept {
+    uint32_t held = 0;
+    for (const uint8_t *page : privateStore) {
+        held += page != nullptr;
+    }
+    return held;
+}
@@ -0,0 +1,130 @@
+#ifndef PAGED_MEMORY_H
+#define PAGED_MEMORY_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+constexpr uint32_t MEMORY_SIZE = 4096U;
+constexpr uint32_t MEMORY_PAGE_SIZE = 256U;
+constexpr uint32_t MEMORY_PAGES = MEMORY_SIZE / MEMORY_PAGE_SIZE;
+
+// Immutable fonts + ROM image, shared by every instance running the same ROM
+struct MemoryImage {
+    uint8_t bytes[MEMORY_SIZE]{};
+    size_t romSize = 0;
+};
+
+/**
+ * Free list of 256-byte pages for PagedMemory
+ * Pages come from caller memory (e.g. a MachinePool arena) and, once that
+ * runs out, from chunks of CHUNK_PAGES allocated on demand. acquire() and
+ * release() only allocate when a new chunk is needed.
+ */
+class PageSlab {
+   private:
+    static constexpr size_t CHUNK_PAGES = 64;
+
+    struct alignas(64) Page {
+        uint8_t bytes[MEMORY_PAGE_SIZE];
+    };
+
+    std::mutex mtx;
+    std::vector<uint8_t *> freeList;    // Reserved to totalPages, so release() never allocates
+    std::vector<std::unique_ptr<Page[]>> chunks;
+    size_t totalPages = 0;
+
+    void add(uint8_t *memory, size_t pages);
+
+   public:
+    PageSlab() = default;
+    // Hand out pages from memory first, MEMORY_PAGE_SIZE aligned, not owned
+    PageSlab(uint8_t *memory, size_t pages);
+
+    PageSlab(const PageSlab &) = delete;
+    PageSlab &operator=(const PageSlab &) = delete;
+
+    uint8_t *acquire();
+    void release(uint8_t *page);
+
+    size_t capacity() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return totalPages;
+    }
+
+    size_t pagesInUse() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return totalPages - freeList.size();
+    }
+
+    // Process-wide slab for instances not given one, never destroyed
+    static PageSlab &shared();
+};
+
+/**
+ * 4 KB address space of 256-byte pages
+ * Pages read through to the shared image until their first write, which
+ * copies that page into a page taken from the slab. Pages are kept across
+ * attach() and restore() for reuse and returned on destruction, so an
+ * instance holds only pages it has written.
+ */
+class PagedMemory {
+   private:
+    std::shared_ptr<const MemoryImage> image;
+    const uint8_t *pages[MEMORY_PAGES]{};
+    uint8_t *privateStore[MEMORY_PAGES]{};  // From slab on first write, valid where privateMask is set
+    uint16_t privateMask = 0;
+    PageSlab *slab = nullptr;               // nullptr = PageSlab::shared()
+
+    PageSlab &pageSource() const {
+        return slab ? *slab : PageSlab::shared();
+    }
+
+    void releasePages();
+
+   public:
+    PagedMemory() = default;
+    PagedMemory(const PagedMemory &other);
+    PagedMemory &operator=(const PagedMemory &other);
+    ~PagedMemory();
+
+    // Take pages from source from now on (nullptr = shared), private pages move over
+    void useSlab(PageSlab *source);
+
+    // Point every page back at the image
+    void attach(std::shared_ptr<const MemoryImage> img);
+
+    // Writable copy of page p, preserve = false skips copying the shared bytes
+    uint8_t *privatePage(uint32_t p, bool preserve = true);
+    void sharePage(uint32_t p);
+
+    uint8_t read(uint16_t address) const {
+        return pages[address / MEMORY_PAGE_SIZE][address % MEMORY_PAGE_SIZE];
+    }
+
+    void write(uint16_t address, uint8_t value) {
+        uint32_t p = address / MEMORY_PAGE_SIZE;
+        uint8_t *dest = (privateMask & (1U << p)) ? privateStore[p] : privatePage(p);
+        dest[address % MEMORY_PAGE_SIZE] = value;
+    }
+
+    const uint8_t *page(uint32_t p) const {
+        return pages[p];
+    }
+
+    uint16_t privatePages() const noexcept {
+        return privateMask;
+    }
+
+    // Pages held from the slab, private or kept for reuse
+    uint32_t heldPages() const noexcept;
+
+    const std::shared_ptr<const MemoryImage> &sharedImage() const noexcept {
+        return image;
+    }
+};
+
+#endif // PAGED_MEMORY_H
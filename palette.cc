@@ -0,0 +1,133 @@
+#include "palette.h"
+
+#ifdef CHIP8_SIMD_X86
+#include <immintrin.h>
+#endif
+
+// Scalar Kernels
+
+static void expandBitsScalar(const uint8_t *bits, size_t pixels, const uint32_t (&colours)[2], uint32_t *out) {
+    for (size_t x = 0; x < pixels; ++x) {
+        out[x] = colours[(bits[x / 8] >> (7 - x % 8)) & 1U];
+    }
+}
+
+static void expandPlanesScalar(const uint8_t *plane0, const uint8_t *plane1, size_t pixels,
+                               const uint32_t (&colours)[4], uint32_t *out) {
+    for (size_t x = 0; x < pixels; ++x) {
+        uint32_t shift = 7 - x % 8;
+        out[x] = colours[((plane0[x / 8] >> shift) & 1U) | (((plane1[x / 8] >> shift) & 1U) << 1)];
+    }
+}
+
+#ifdef CHIP8_SIMD_X86
+/**
+ * Broadcast one packed byte to every lane, AND with the lane's bit and
+ * compare : all-ones lanes are lit, then blend the palette entries
+ */
+
+// SSE2 has no blendv, select with and / andnot / or
+__attribute__((target("sse2"))) static inline __m128i selectSse2(__m128i mask, __m128i lit, __m128i unlit) {
+    return _mm_or_si128(_mm_and_si128(mask, lit), _mm_andnot_si128(mask, unlit));
+}
+
+__attribute__((target("sse2"))) static void expandBitsSse2(const uint8_t *bits, size_t pixels,
+                                                          const uint32_t (&colours)[2], uint32_t *out) {
+    const __m128i high = _mm_set_epi32(0x10, 0x20, 0x40, 0x80);
+    const __m128i low = _mm_set_epi32(0x01, 0x02, 0x04, 0x08);
+    const __m128i c0 = _mm_set1_epi32(static_cast<int>(colours[0]));
+    const __m128i c1 = _mm_set1_epi32(static_cast<int>(colours[1]));
+
+    for (size_t b = 0; b < pixels / 8; ++b) {
+        __m128i v = _mm_set1_epi32(bits[b]);
+        __m128i m0 = _mm_cmpeq_epi32(_mm_and_si128(v, high), high);
+        __m128i m1 = _mm_cmpeq_epi32(_mm_and_si128(v, low), low);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + b * 8), selectSse2(m0, c1, c0));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + b * 8 + 4), selectSse2(m1, c1, c0));
+    }
+}
+
+__attribute__((target("sse2"))) static void expandPlanesSse2(const uint8_t *plane0, const uint8_t *plane1, size_t pixels,
+                                                            const uint32_t (&colours)[4], uint32_t *out) {
+    const __m128i halves[2] = {_mm_set_epi32(0x10, 0x20, 0x40, 0x80), _mm_set_epi32(0x01, 0x02, 0x04, 0x08)};
+    const __m128i c0 = _mm_set1_epi32(static_cast<int>(colours[0]));
+    const __m128i c1 = _mm_set1_epi32(static_cast<int>(colours[1]));
+    const __m128i c2 = _mm_set1_epi32(static_cast<int>(colours[2]));
+    const __m128i c3 = _mm_set1_epi32(static_cast<int>(colours[3]));
+
+    for (size_t b = 0; b < pixels / 8; ++b) {
+        __m128i p0 = _mm_set1_epi32(plane0[b]);
+        __m128i p1 = _mm_set1_epi32(plane1[b]);
+
+        for (int h = 0; h < 2; ++h) {
+            __m128i m0 = _mm_cmpeq_epi32(_mm_and_si128(p0, halves[h]), halves[h]);
+            __m128i m1 = _mm_cmpeq_epi32(_mm_and_si128(p1, halves[h]), halves[h]);
+            __m128i colour = selectSse2(m1, selectSse2(m0, c3, c2), selectSse2(m0, c1, c0));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + b * 8 + h * 4), colour);
+        }
+    }
+}
+
+__attribute__((target("avx2"))) static void expandBitsAvx2(const uint8_t *bits, size_t pixels,
+                                                          const uint32_t (&colours)[2], uint32_t *out) {
+    const __m256i lanes = _mm256_set_epi32(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80);
+    const __m256i c0 = _mm256_set1_epi32(static_cast<int>(colours[0]));
+    const __m256i c1 = _mm256_set1_epi32(static_cast<int>(colours[1]));
+
+    for (size_t b = 0; b < pixels / 8; ++b) {
+        __m256i v = _mm256_set1_epi32(bits[b]);
+        __m256i lit = _mm256_cmpeq_epi32(_mm256_and_si256(v, lanes), lanes);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + b * 8), _mm256_blendv_epi8(c0, c1, lit));
+    }
+}
+
+__attribute__((target("avx2"))) static void expandPlanesAvx2(const uint8_t *plane0, const uint8_t *plane1, size_t pixels,
+                                                            const uint32_t (&colours)[4], uint32_t *out) {
+    const __m256i lanes = _mm256_set_epi32(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80);
+    const __m256i c0 = _mm256_set1_epi32(static_cast<int>(colours[0]));
+    const __m256i c1 = _mm256_set1_epi32(static_cast<int>(colours[1]));
+    const __m256i c2 = _mm256_set1_epi32(static_cast<int>(colours[2]));
+    const __m256i c3 = _mm256_set1_epi32(static_cast<int>(colours[3]));
+
+    for (size_t b = 0; b < pixels / 8; ++b) {
+        __m256i m0 = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(plane0[b]), lanes), lanes);
+        __m256i m1 = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(plane1[b]), lanes), lanes);
+        __m256i colour = _mm256_blendv_epi8(_mm256_blendv_epi8(c0, c1, m0), _mm256_blendv_epi8(c2, c3, m0), m1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + b * 8), colour);
+    }
+}
+#endif
+
+void expandBits(const uint8_t *bits, size_t pixels, const uint32_t (&colours)[2], uint32_t *out, SimdLevel level) {
+#ifdef CHIP8_SIMD_X86
+    if (level == SimdLevel::AVX2) {
+        expandBitsAvx2(bits, pixels, colours, out);
+        return;
+    }
+    if (level == SimdLevel::SSE2) {
+        expandBitsSse2(bits, pixels, colours, out);
+        return;
+    }
+#endif
+    expandBitsScalar(bits, pixels, colours, out);
+}
+
+void expandPlanes(const uint8_t *plane0, const uint8_t *plane1, size_t pixels, const uint32_t (&colours)[4],
+                  uint32_t *out, SimdLevel level) {
+#ifdef CHIP8_SIMD_X86
+    if (level == SimdLevel::AVX2) {
+        expandPlanesAvx2(plane0, plane1, pixels, colours, out);
+        return;
+    }
+    if (level == SimdLevel::SSE2) {
+        expandPlanesSse2(plane0, plane1, pixels, colours, out);
+        return;
+    }
+#endif
+    expandPlanesScalar(plane0, plane1, pixels, colours, out);
+}
+
+void expandDisplay(const uint8_t (&display)[VIDEO_HEIGHT][VIDEO_ROW_BYTES], const uint32_t (&colours)[2], uint32_t *out) {
+    expandBits(&display[0][0], VIDEO_WIDTH * VIDEO_HEIGHT, colours, out);
+}
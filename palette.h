@@ -0,0 +1,40 @@
+#ifndef PALETTE_H
+#define PALETTE_H
+
+#include <cstdint>
+#include <cstddef>
+
+#include "chip8.h"
+#include "utils/simd.h"
+
+// 0xRRGGBB -> uint32 whose bytes in memory are R, G, B, A (little endian)
+constexpr uint32_t toRGBA(uint32_t rgb) {
+    return 0xFF000000U | ((rgb & 0xFFU) << 16) | (rgb & 0xFF00U) | ((rgb >> 16) & 0xFFU);
+}
+
+// 0xRRGGBB -> 0xAARRGGBB (SDL_PIXELFORMAT_ARGB8888)
+constexpr uint32_t toARGB(uint32_t rgb) {
+    return 0xFF000000U | (rgb & 0xFFFFFFU);
+}
+
+/**
+ * Theme colours are 0xRRGGBB (EmuSettings::theme); CHIP-8 uses the first
+ * two, XO-CHIP's two bitplanes index all four
+ */
+
+/**
+ * Packed 1 bpp rows (MSB = leftmost) to 32-bit colour
+ * colours[] is already in the output format, see toRGBA() / toARGB()
+ * pixels must be a multiple of 8
+ */
+void expandBits(const uint8_t *bits, size_t pixels, const uint32_t (&colours)[2], uint32_t *out,
+                SimdLevel level = detectSimd());
+
+// Two planes, colour index = plane0 bit | plane1 bit << 1
+void expandPlanes(const uint8_t *plane0, const uint8_t *plane1, size_t pixels, const uint32_t (&colours)[4],
+                  uint32_t *out, SimdLevel level = detectSimd());
+
+// Whole display, e.g. for screenshots or recording : out is VIDEO_HEIGHT x VIDEO_WIDTH
+void expandDisplay(const uint8_t (&display)[VIDEO_HEIGHT][VIDEO_ROW_BYTES], const uint32_t (&colours)[2], uint32_t *out);
+
+#endif // PALETTE_H
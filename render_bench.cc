@@ -0,0 +1,123 @@
+/**
+ * Software renderer benchmark
+ * chip8render_bench [rom] : frames per second at 1080p and 4K per kernel,
+ * then 1 bpp -> RGBA palette expansion of the bare 64x32 display
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+
+#include "chip8.h"
+#include "soft_renderer.h"
+#include "palette.h"
+#include "utils/hash.h"
+
+struct Resolution {
+    const char *name;
+    uint32_t width;
+    uint32_t height;
+};
+
+int main(int argc, char *argv[]) {
+    using clock = std::chrono::steady_clock;
+
+    //A real frame : run the ROM for a few seconds of game time
+    Chip8 chip8;
+    if (!chip8.loadROM(argc > 1 ? argv[1] : "rom/Space Invaders [David Winter].ch8")) {
+        return 1;      //A blank display would make every kernel look fast
+    }
+    for (int f = 0; f < 300; ++f) {
+        chip8.runFrame(12);
+    }
+
+    const Resolution resolutions[] = {
+        {"App x10", VIDEO_WIDTH * 10, VIDEO_HEIGHT * 10},
+        {"1080p", 1920, 1080},
+        {"4K", 3840, 2160},
+    };
+
+    for (const auto &res : resolutions) {
+        std::vector<uint32_t> pixels(size_t(res.width) * res.height);
+
+        for (bool integerScale : {true, false}) {
+            uint64_t reference = 0;
+
+            for (auto level : {SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2}) {
+                SoftRenderer renderer(res.width, res.height, integerScale);
+                renderer.setSimd(level);
+                if (renderer.simdLevel() != level) {
+                    continue;
+                }
+
+                //Run for ~0.5 s
+                uint64_t frames = 0;
+                auto start = clock::now();
+                auto elapsed = std::chrono::duration<double>(0);
+                do {
+                    renderer.render(chip8.display, pixels.data(), res.width * sizeof(uint32_t));
+                    ++frames;
+                    elapsed = clock::now() - start;
+                } while (elapsed.count() < 0.5);
+
+                uint64_t checksum = hashBytes(pixels.data(), pixels.size() * sizeof(uint32_t));
+                if (level == SimdLevel::SCALAR) {
+                    reference = checksum;
+                }
+
+                double fps = frames / elapsed.count();
+                std::cout << std::left << std::setw(8) << res.name << std::setw(11) << (integerScale ? "integer" : "fractional")
+                          << std::setw(7) << simdName(level) << std::right << std::fixed << std::setprecision(0)
+                          << std::setw(8) << fps << " fps " << std::setprecision(2)
+                          << std::setw(6) << fps * pixels.size() * sizeof(uint32_t) / 1e9 << " GB/s"
+                          << (checksum == reference ? "" : "  MISMATCH") << std::endl;
+            }
+        }
+    }
+
+    //Palette expansion, two colours and XO-CHIP's two planes (the display against itself shifted by a row)
+    const uint32_t colours[4] = {toRGBA(0x101010), toRGBA(0xE0E0E0), toRGBA(0xAA5500), toRGBA(0x0055AA)};
+    const uint32_t two[2] = {colours[0], colours[1]};
+    const uint8_t *plane0 = &chip8.display[0][0];
+    const uint8_t *plane1 = &chip8.display[1][0];
+    constexpr size_t pixels = VIDEO_WIDTH * VIDEO_HEIGHT;
+    constexpr size_t planePixels = VIDEO_WIDTH * (VIDEO_HEIGHT - 1);
+    std::vector<uint32_t> rgba(pixels);
+
+    for (int planes : {1, 2}) {
+        uint64_t reference = 0;
+
+        for (auto level : {SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2}) {
+            if (level > detectSimd()) {
+                continue;
+            }
+
+            uint64_t frames = 0;
+            auto start = clock::now();
+            auto elapsed = std::chrono::duration<double>(0);
+            do {
+                for (int i = 0; i < 1000; ++i) {
+                    if (planes == 1) {
+                        expandBits(plane0, pixels, two, rgba.data(), level);
+                    } else {
+                        expandPlanes(plane0, plane1, planePixels, colours, rgba.data(), level);
+                    }
+                }
+                frames += 1000;
+                elapsed = clock::now() - start;
+            } while (elapsed.count() < 0.5);
+
+            uint64_t checksum = hashBytes(rgba.data(), rgba.size() * sizeof(uint32_t));
+            if (level == SimdLevel::SCALAR) {
+                reference = checksum;
+            }
+
+            std::cout << std::left << std::setw(8) << "Palette" << std::setw(11) << (planes == 1 ? "2 colour" : "4 colour")
+                      << std::setw(7) << simdName(level) << std::right << std::fixed << std::setprecision(1)
+                      << std::setw(8) << elapsed.count() * 1e9 / frames << " ns/frame"
+                      << (checksum == reference ? "" : "  MISMATCH") << std::endl;
+        }
+    }
+    return 0;
+}
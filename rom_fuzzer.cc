@@ -0,0 +1,217 @@
+#include "rom_fuzzer.h"
+
+#include <memory>
+#include <random>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+#include "vec_env.h"
+
+namespace {
+
+// Hit counts folded into AFL-style buckets
+constexpr std::array<uint8_t, 256> makeCountClass() {
+    std::array<uint8_t, 256> table{};
+    for (int i = 0; i < 256; ++i) {
+        table[i] = i == 0 ? 0 : i == 1 ? 1 : i == 2 ? 2 : i == 3 ? 4 :
+                   i < 8 ? 8 : i < 16 ? 16 : i < 32 ? 32 : i < 128 ? 64 : 128;
+    }
+    return table;
+}
+
+constexpr std::array<uint8_t, 256> COUNT_CLASS = makeCountClass();
+
+void mutateRom(std::vector<uint8_t> &rom, const std::vector<uint8_t> &other, std::mt19937 &rng) {
+    if (rom.empty()) {
+        return;
+    }
+
+    uint32_t stack = 1 + rng() % 4;
+    for (uint32_t s = 0; s < stack; ++s) {
+        size_t pos = rng() % rom.size();
+
+        switch (rng() % 6) {
+            case 0: rom[pos] ^= 1U << (rng() % 8); break;                   //Bit flip
+            case 1: rom[pos] = static_cast<uint8_t>(rng()); break;           //Random byte
+            case 2: rom[pos] += static_cast<uint8_t>(1 + rng() % 8); break;  //Arithmetic
+            case 3: rom[pos] -= static_cast<uint8_t>(1 + rng() % 8); break;
+            case 4: {                                                       //Random opcode
+                pos &= ~size_t(1);
+                uint16_t op = static_cast<uint16_t>(rng());
+                rom[pos] = op >> 8;
+                if (pos + 1 < rom.size()) {
+                    rom[pos + 1] = op & 0xFF;
+                }
+                break;
+            }
+            case 5: {                                                       //Splice tail
+                size_t common = std::min(other.size(), rom.size());
+                if (pos < common) {
+                    std::copy(other.begin() + pos, other.begin() + common, rom.begin() + pos);
+                }
+                break;
+            }
+        }
+    }
+}
+
+void mutateScript(std::vector<InputEvent> &script, const FuzzerConfig &config, std::mt19937 &rng) {
+    auto randomEvent = [&] {
+        return InputEvent{static_cast<uint16_t>(rng() % config.framesPerExec),
+                          static_cast<int8_t>(static_cast<int>(rng() % 17) - 1)};
+    };
+
+    switch (rng() % 3) {
+        case 0:
+            if (script.size() < config.maxInputEvents) {
+                script.push_back(randomEvent());
+                break;
+            }
+            [[fallthrough]];
+        case 1:
+            if (!script.empty()) {
+                script[rng() % script.size()] = randomEvent();
+            }
+            break;
+        case 2:
+            if (!script.empty()) {
+                script.erase(script.begin() + rng() % script.size());
+            }
+            break;
+    }
+
+    std::sort(script.begin(), script.end(), [](const InputEvent &a, const InputEvent &b) {
+        return a.frame < b.frame;
+    });
+}
+
+}  // namespace
+
+void FuzzReport::print(std::ostream &os) const {
+    os << "Executions : " << executions << " (" << static_cast<uint64_t>(execsPerSecond) << " /s)\n"
+       << "Edges : " << edges << "\n"
+       << "Corpus : " << corpusSize << "\n"
+       << "Crashes : " << crashCount << std::endl;
+}
+
+RomFuzzer::RomFuzzer(const FuzzerConfig &cfg) : config(cfg) {
+    if (config.numThreads == 0) {
+        config.numThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    config.framesPerExec = std::max(1U, config.framesPerExec);
+}
+
+void RomFuzzer::fuzzThread(const std::vector<uint8_t> &seedRom, uint32_t seed,
+                           CoverageMap &virgin, FuzzReport &report) const {
+    Chip8 env;
+    env.seed(seed);
+    if (!env.loadROM(seedRom.data(), seedRom.size())) {
+        return;
+    }
+
+    //Post-load snapshot, the ROM region is patched per execution
+    auto snapshot = std::make_unique<Chip8::State>();
+    env.clone(*snapshot);
+
+    CoverageMap trace{};
+    std::mt19937 rng(seed);
+    std::vector<FuzzInput> corpus{FuzzInput{seedRom, {}}};
+    FuzzInput candidate;
+
+    for (uint64_t n = 0; n < config.executions; ++n) {
+        const FuzzInput &parent = corpus[rng() % corpus.size()];
+        candidate.rom.assign(parent.rom.begin(), parent.rom.end());
+        candidate.script.assign(parent.script.begin(), parent.script.end());
+
+        //The first execution runs the seed as-is, it only fills the virgin map
+        if (n > 0 && config.mutateRom) {
+            mutateRom(candidate.rom, corpus[rng() % corpus.size()].rom, rng);
+        }
+        if (n > 0 && config.mutateInputs) {
+            mutateScript(candidate.script, config, rng);
+        }
+
+        //Reset
+        env.patch(*snapshot, START_ADDRESS, candidate.rom.data(), candidate.rom.size());
+        env.restore(*snapshot);
+        trace.fill(0);
+        env.setCoverageMap(trace.data());
+
+        //Execute
+        auto event = candidate.script.begin();
+        for (uint32_t f = 0; f < config.framesPerExec && !env.getFaults(); ++f) {
+            for (; event != candidate.script.end() && event->frame <= f; ++event) {
+                applyAction(env, event->key);
+            }
+            env.runFrame(config.instructionsPerFrame);
+        }
+
+        //New Coverage, most of the map is zero so it is scanned a word at a time
+        bool interesting = false;
+        for (size_t w = 0; w < trace.size(); w += 8) {
+            uint64_t word;
+            std::memcpy(&word, &trace[w], 8);
+            if (!word) {
+                continue;
+            }
+
+            for (size_t i = w; i < w + 8; ++i) {
+                uint8_t bucket = COUNT_CLASS[trace[i]];
+                if (bucket & ~virgin[i]) {
+                    virgin[i] |= bucket;
+                    interesting = true;
+                }
+            }
+        }
+
+        if (env.getFaults()) {
+            ++report.crashCount;
+            if (interesting && report.crashes.size() < config.maxCrashes) {
+                report.crashes.emplace_back(env.getFaults(), candidate);
+            }
+        } else if (interesting && n > 0) {
+            corpus.push_back(candidate);
+        }
+    }
+
+    env.setCoverageMap(nullptr);
+    report.executions = config.executions;
+    report.corpusSize = corpus.size();
+}
+
+FuzzReport RomFuzzer::run(const std::vector<uint8_t> &seedRom) const {
+    std::vector<CoverageMap> virgin(config.numThreads, CoverageMap{});
+    std::vector<FuzzReport> reports(config.numThreads);
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t t = 1; t < config.numThreads; ++t) {
+        threads.emplace_back(&RomFuzzer::fuzzThread, this, std::cref(seedRom), config.seed + static_cast<uint32_t>(t),
+                             std::ref(virgin[t]), std::ref(reports[t]));
+    }
+    fuzzThread(seedRom, config.seed, virgin[0], reports[0]);
+
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    FuzzReport total;
+    CoverageMap merged{};
+    for (size_t t = 0; t < config.numThreads; ++t) {
+        total.executions += reports[t].executions;
+        total.corpusSize += reports[t].corpusSize;
+        total.crashCount += reports[t].crashCount;
+        std::move(reports[t].crashes.begin(), reports[t].crashes.end(), std::back_inserter(total.crashes));
+
+        for (size_t i = 0; i < merged.size(); ++i) {
+            merged[i] |= virgin[t][i];
+        }
+    }
+    total.edges = std::count_if(merged.begin(), merged.end(), [](uint8_t v) { return v != 0; });
+    total.execsPerSecond = elapsed > 0 ? total.executions / elapsed : 0.0;
+    return total;
+}
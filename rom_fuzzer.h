@@ -0,0 +1,63 @@
+#ifndef ROM_FUZZER_H
+#define ROM_FUZZER_H
+
+#include <vector>
+#include <array>
+#include <ostream>
+
+#include "chip8.h"
+
+// Key held from a given frame onwards (-1 releases)
+struct InputEvent {
+    uint16_t frame;
+    int8_t key;
+};
+
+struct FuzzInput {
+    std::vector<uint8_t> rom;
+    std::vector<InputEvent> script;     // Sorted by frame
+};
+
+struct FuzzerConfig {
+    size_t numThreads = 0;              // 0 = hardware_concurrency
+    uint64_t executions = 100000;       // Per thread
+    uint32_t framesPerExec = 30;
+    uint32_t instructionsPerFrame = 10;
+    uint32_t maxInputEvents = 16;
+    uint32_t maxCrashes = 32;           // Crash inputs kept per thread
+    bool mutateRom = true;
+    bool mutateInputs = true;
+    uint32_t seed = 1;
+};
+
+struct FuzzReport {
+    uint64_t executions = 0;
+    uint64_t edges = 0;
+    uint64_t corpusSize = 0;
+    uint64_t crashCount = 0;
+    double execsPerSecond = 0.0;
+    std::vector<std::pair<uint8_t, FuzzInput>> crashes;    // Fault bits, input
+
+    void print(std::ostream &os) const;
+};
+
+/**
+ * Coverage-guided fuzzer over ROM bytes and input scripts
+ * Every execution restores the post-load snapshot instead of reloading
+ */
+class RomFuzzer {
+   private:
+    FuzzerConfig config;
+
+    using CoverageMap = std::array<uint8_t, COVERAGE_MAP_SIZE>;
+
+    void fuzzThread(const std::vector<uint8_t> &seedRom, uint32_t seed,
+                    CoverageMap &virgin, FuzzReport &report) const;
+
+   public:
+    explicit RomFuzzer(const FuzzerConfig &cfg);
+
+    FuzzReport run(const std::vector<uint8_t> &seedRom) const;
+};
+
+#endif // ROM_FUZZER_H
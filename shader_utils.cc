@@ -1,77 +1,160 @@
 #include "shader_utils.h"
 
-GLuint LoadShaders(const char *vertexShader, const char *fragmentShader) {
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+
+#include "embedded_shaders.h"
+#include "utils/hash.h"
 
-    GLuint vertexShaderID = glCreateShader(GL_VERTEX_SHADER);
-    GLuint fragmentShaderID = glCreateShader(GL_FRAGMENT_SHADER);
+namespace fs = std::filesystem;
 
-    std::stringstream ss;
+// Header in front of a cached program binary
+struct ProgramCacheHeader {
+    uint32_t magic;
+    uint32_t format;        //From glGetProgramBinary
+    uint64_t key;           //programCacheKey() it was written under
+};
 
-    std::string vertexShaderCode;
-    std::ifstream vertexfile(vertexShader, std::ios::in);
+constexpr uint32_t PROGRAM_CACHE_MAGIC = 0x42503843;   //"C8PB"
 
-    std::cerr << "\nLoading Shaders : " << vertexShader << " ";
-    if (vertexfile.is_open()) {
-        ss << vertexfile.rdbuf();
-        vertexShaderCode = ss.str();
-        vertexfile.close();
-    } else {
-        std::cerr << "| Cannot open File \n";
+const char *embeddedShader(const char *name) {
+    for (const auto &shader : EMBEDDED_SHADERS) {
+        if (std::strcmp(shader.name, name) == 0) {
+            return shader.source;
+        }
+    }
+    return nullptr;
+}
+
+// <user cache>/chip8emu, empty if there is no home to put it in
+static fs::path programCacheDir() {
+    const char *dir = nullptr;
+#if defined(_WIN32)
+    if ((dir = std::getenv("LOCALAPPDATA"))) {
+        return fs::path(dir) / "chip8emu";
+    }
+#elif defined(__APPLE__)
+    if ((dir = std::getenv("HOME"))) {
+        return fs::path(dir) / "Library" / "Caches" / "chip8emu";
+    }
+#else
+    if ((dir = std::getenv("XDG_CACHE_HOME")) && *dir) {
+        return fs::path(dir) / "chip8emu";
+    }
+    if ((dir = std::getenv("HOME"))) {
+        return fs::path(dir) / ".cache" / "chip8emu";
+    }
+#endif
+    return {};
+}
+
+// Binaries are only valid for the driver that produced them, and for the same sources
+static uint64_t programCacheKey(const char *vertexCode, const char *fragmentCode) {
+    uint64_t key = 0;
+    for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+        auto text = reinterpret_cast<const char *>(glGetString(name));
+        if (text) {
+            key = hashBytes(text, std::strlen(text), key);
+        }
+    }
+    key = hashBytes(vertexCode, std::strlen(vertexCode), key);
+    return hashBytes(fragmentCode, std::strlen(fragmentCode), key);
+}
+
+static bool programBinarySupported() {
+    GLint formats = 0;
+    if (GLEW_ARB_get_program_binary) {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    }
+    return formats > 0;
+}
+
+// A linked program from the cache, 0 on a miss or if the driver rejects it
+static GLuint loadProgramBinary(const fs::path &file, uint64_t key) {
+    std::ifstream in(file, std::ios::binary);
+    ProgramCacheHeader header{};
+    if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        header.magic != PROGRAM_CACHE_MAGIC || header.key != key) {
         return 0;
     }
+    std::vector<char> binary((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
 
-    std::string fragmentShaderCode;
-    std::ifstream fragmentFile(fragmentShader, std::ios::in);
+    GLuint programID = glCreateProgram();
+    glProgramBinary(programID, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
 
-    std::cerr << "\nLoading Shaders : " << fragmentShader << " ";
-    if (fragmentFile.is_open()) {
-        ss.str(std::string());
-        ss << fragmentFile.rdbuf();
-        fragmentShaderCode = ss.str();
-        fragmentFile.close();
-    } else {
-        std::cerr << "| Cannot open File \n";
+    GLint linked = GL_FALSE;
+    glGetProgramiv(programID, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        glDeleteProgram(programID);
         return 0;
     }
+    return programID;
+}
 
-    GLint result = GL_FALSE;
-    int infoLogLength = 0;
+// Written to a temporary name and renamed, so a concurrent launch never reads half a file
+static void saveProgramBinary(const fs::path &file, uint64_t key, GLuint programID) {
+    GLint length = 0;
+    glGetProgramiv(programID, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
 
-    //Compile Vertex Shader
-    std::cerr << "\nCompiling Shader : " << vertexShader << " \n";
-    char const *vertexCodeptr = vertexShaderCode.c_str();
-    glShaderSource(vertexShaderID, 1, &vertexCodeptr, NULL);
-    glCompileShader(vertexShaderID);
+    ProgramCacheHeader header{PROGRAM_CACHE_MAGIC, 0, key};
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(programID, length, &length, &format, binary.data());
+    header.format = format;
 
-    glGetShaderiv(vertexShaderID, GL_COMPILE_STATUS, &result);
-    glGetShaderiv(vertexShaderID, GL_INFO_LOG_LENGTH, &infoLogLength);
+    std::error_code ec;
+    fs::create_directories(file.parent_path(), ec);
+    fs::path temp = file;
+    temp += ".tmp";
 
-    if (!result) {
-        std::string VertexShaderErrorMessage;
-        VertexShaderErrorMessage.resize(infoLogLength + 1);
-        glGetShaderInfoLog(vertexShaderID, infoLogLength, NULL, VertexShaderErrorMessage.data());
-        std::cerr << VertexShaderErrorMessage << "\n";
+    std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(binary.data(), length);
+    out.close();
+    if (!out) {
+        fs::remove(temp, ec);
+        return;
     }
+    fs::rename(temp, file, ec);
+}
 
-    //Compile Fragment Shader
-    std::cerr << "Compiling Shader : " << fragmentShader << " \n";
-    char const *fragmentCodeptr = fragmentShaderCode.c_str();
-    glShaderSource(fragmentShaderID, 1, &fragmentCodeptr, NULL);
-    glCompileShader(fragmentShaderID);
+static GLuint compileShader(GLenum type, const char *name, const char *code) {
+    GLint result = GL_FALSE;
+    int infoLogLength = 0;
 
-    glGetShaderiv(fragmentShaderID, GL_COMPILE_STATUS, &result);
-    glGetShaderiv(fragmentShaderID, GL_INFO_LOG_LENGTH, &infoLogLength);
+    std::cerr << "Compiling Shader : " << name << " \n";
+    GLuint shaderID = glCreateShader(type);
+    glShaderSource(shaderID, 1, &code, NULL);
+    glCompileShader(shaderID);
+
+    glGetShaderiv(shaderID, GL_COMPILE_STATUS, &result);
+    glGetShaderiv(shaderID, GL_INFO_LOG_LENGTH, &infoLogLength);
 
     if (!result) {
-        std::string FragmentShaderErrorMessage;
-        FragmentShaderErrorMessage.resize(infoLogLength + 1);
-        glGetShaderInfoLog(fragmentShaderID, infoLogLength, NULL, FragmentShaderErrorMessage.data());
-        std::cerr << FragmentShaderErrorMessage << "\n";
+        std::string ShaderErrorMessage;
+        ShaderErrorMessage.resize(infoLogLength + 1);
+        glGetShaderInfoLog(shaderID, infoLogLength, NULL, ShaderErrorMessage.data());
+        std::cerr << ShaderErrorMessage << "\n";
     }
+    return shaderID;
+}
+
+static GLuint linkProgram(GLuint vertexShaderID, GLuint fragmentShaderID, bool retrievable) {
+    GLint result = GL_FALSE;
+    int infoLogLength = 0;
 
-    //Link
     std::cerr << "Linking Program\n";
     GLuint programID = glCreateProgram();
+    if (retrievable) {
+        glProgramParameteri(programID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
     glAttachShader(programID, vertexShaderID);
     glAttachShader(programID, fragmentShaderID);
     glLinkProgram(programID);
@@ -82,7 +165,7 @@ GLuint LoadShaders(const char *vertexShader, const char *fragmentShader) {
     if (!result) {
         std::string ProgramErrorMessage;
         ProgramErrorMessage.resize(infoLogLength + 1);
-        glGetShaderInfoLog(programID, infoLogLength, NULL, ProgramErrorMessage.data());
+        glGetProgramInfoLog(programID, infoLogLength, NULL, ProgramErrorMessage.data());
         std::cerr << ProgramErrorMessage << "\n";
     }
 
@@ -91,6 +174,51 @@ GLuint LoadShaders(const char *vertexShader, const char *fragmentShader) {
     glDeleteShader(vertexShaderID);
     glDeleteShader(fragmentShaderID);
 
+    if (!result) {
+        glDeleteProgram(programID);
+        return 0;
+    }
+    return programID;
+}
+
+GLuint LoadShaders(const char *vertexShader, const char *fragmentShader) {
+    auto start = std::chrono::steady_clock::now();
+
+    const char *vertexCode = embeddedShader(vertexShader);
+    const char *fragmentCode = embeddedShader(fragmentShader);
+    if (!vertexCode || !fragmentCode) {
+        std::cerr << "Loading Shaders : " << (vertexCode ? fragmentShader : vertexShader) << " | Not embedded\n";
+        return 0;
+    }
+
+    //Cached binary first, keyed by driver and sources
+    const bool cacheable = programBinarySupported();
+    const fs::path cacheDir = programCacheDir();
+    const uint64_t key = programCacheKey(vertexCode, fragmentCode);
+    fs::path cacheFile;
+    if (cacheable && !cacheDir.empty()) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "program-%016llx.bin", static_cast<unsigned long long>(key));
+        cacheFile = cacheDir / name;
+    }
+
+    GLuint programID = cacheFile.empty() ? 0 : loadProgramBinary(cacheFile, key);
+    const char *source = "cached binary";
+
+    if (!programID) {
+        GLuint vertexShaderID = compileShader(GL_VERTEX_SHADER, vertexShader, vertexCode);
+        GLuint fragmentShaderID = compileShader(GL_FRAGMENT_SHADER, fragmentShader, fragmentCode);
+        programID = linkProgram(vertexShaderID, fragmentShaderID, !cacheFile.empty());
+        source = "compiled";
+
+        if (programID && !cacheFile.empty()) {
+            saveProgramBinary(cacheFile, key, programID);
+        }
+    }
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::cerr << "Shader Setup : " << vertexShader << " + " << fragmentShader << " | " << source << " | "
+              << elapsed.count() << " ms" << (cacheable ? "" : " (no program binary support)") << "\n";
     return programID;
 }
 
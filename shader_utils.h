@@ -8,6 +8,14 @@
 #include <sstream>
 #include <GL/glew.h>
 
+// Source of a shader embedded from shaders/ at build time, by file name; nullptr if unknown
+const char *embeddedShader(const char *name);
+
+/**
+ * Program from two embedded shaders, e.g. LoadShaders("vertex.glsl", "frag.glsl")
+ * The linked binary is cached under the user cache directory, keyed by
+ * driver and sources, and reused on later launches. 0 on failure.
+ */
 GLuint LoadShaders(const char *vertexShader, const char *fragmentShader);
 
 void debugCallback(GLenum source, GLenum type, GLuint id, GLenum severity,
@@ -4,8 +4,17 @@ in vec2 UV;
 
 out vec4 color;
 
-uniform sampler2D textureSampler;
+// One byte per 8 pixels, MSB = leftmost
+uniform usampler2D displaySampler;
+uniform vec4 foreground;
+uniform vec4 background;
 
 void main(){
-    color = texture(textureSampler, UV); 
-}
\ No newline at end of file
+    ivec2 size = textureSize(displaySampler, 0) * ivec2(8, 1);
+    ivec2 pixel = min(ivec2(UV * vec2(size)), size - 1);
+
+    uint row = texelFetch(displaySampler, ivec2(pixel.x >> 3, pixel.y), 0).r;
+    uint lit = (row >> uint(7 - (pixel.x & 7))) & 1u;
+
+    color = lit != 0u ? foreground : background;
+}
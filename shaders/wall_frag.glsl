@@ -0,0 +1,21 @@
+#version 330 core
+
+in vec2 UV;
+flat in int layer;
+
+out vec4 color;
+
+// One layer per screen, one byte per 8 pixels, MSB = leftmost
+uniform usampler2DArray displaySampler;
+uniform vec4 foreground;
+uniform vec4 background;
+
+void main(){
+    ivec2 size = textureSize(displaySampler, 0).xy * ivec2(8, 1);
+    ivec2 pixel = min(ivec2(UV * vec2(size)), size - 1);
+
+    uint row = texelFetch(displaySampler, ivec3(pixel.x >> 3, pixel.y, layer), 0).r;
+    uint lit = (row >> uint(7 - (pixel.x & 7))) & 1u;
+
+    color = lit != 0u ? foreground : background;
+}
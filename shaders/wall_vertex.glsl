@@ -0,0 +1,19 @@
+#version 330 core
+
+layout(location = 0) in vec3 vertexPos_M;
+
+out vec2 UV;
+flat out int layer;
+
+// Columns, rows of the wall; instance n is cell (n % columns, n / columns), row 0 at the top
+uniform ivec2 grid;
+
+void main() {
+    ivec2 cell = ivec2(gl_InstanceID % grid.x, gl_InstanceID / grid.x);
+    vec2 size = 2.0 / vec2(grid);
+    vec2 corner = (vertexPos_M.xy + 1.0) / 2.0;
+
+    UV = vec2(corner.x, 1.0 - corner.y);
+    layer = gl_InstanceID;
+    gl_Position = vec4(-1.0 + size.x * (float(cell.x) + corner.x), 1.0 - size.y * (float(cell.y) + 1.0 - corner.y), 0.0, 1.0);
+}
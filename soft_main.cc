@@ -0,0 +1,230 @@
+/**
+ * Software-rendered window for hosts without usable GL
+ * chip8soft [--scale N] [--stretch] [--hz N] rom
+ * SoftRenderer draws straight into the SDL window surface, no GL context
+ * is created. Colours come from [Theme] in chip8emu.ini next to the binary.
+ * Keys as in the GL window (1234 / QWER / ASDF / ZXCV), Enter resets,
+ * F12 saves a 64x32 screenshot, Esc quits. No sound.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+
+#include <SDL2/SDL.h>
+
+#include "chip8.h"
+#include "soft_renderer.h"
+#include "palette.h"
+#include "utils/framePacer.h"
+#include "utils/configReader.h"
+
+static constexpr SDL_Scancode KEY_MAPPING[16] = {
+    SDL_SCANCODE_X, SDL_SCANCODE_1, SDL_SCANCODE_2, SDL_SCANCODE_3,
+    SDL_SCANCODE_Q, SDL_SCANCODE_W, SDL_SCANCODE_E, SDL_SCANCODE_A,
+    SDL_SCANCODE_S, SDL_SCANCODE_D, SDL_SCANCODE_Z, SDL_SCANCODE_C,
+    SDL_SCANCODE_4, SDL_SCANCODE_R, SDL_SCANCODE_F, SDL_SCANCODE_V,
+};
+
+// Window surface, or an ARGB8888 shadow blitted onto it when the window uses another format
+struct Target {
+    SDL_Surface *window = nullptr;
+    SDL_Surface *shadow = nullptr;
+
+    SDL_Surface *drawn() const {
+        return shadow ? shadow : window;
+    }
+
+    void release() {
+        if (shadow) {
+            SDL_FreeSurface(shadow);
+            shadow = nullptr;
+        }
+    }
+};
+
+// Display in the theme colours as a binary PPM
+static bool saveScreenshot(const Chip8 &chip8, const uint32_t (&theme)[4], const std::string &path) {
+    const uint32_t colours[2] = {toRGBA(theme[0]), toRGBA(theme[1])};
+    uint32_t rgba[VIDEO_HEIGHT * VIDEO_WIDTH];
+    expandDisplay(chip8.display, colours, rgba);
+
+    std::ofstream file(path, std::ios::binary);
+    file << "P6\n" << VIDEO_WIDTH << " " << VIDEO_HEIGHT << "\n255\n";
+    for (uint32_t pixel : rgba) {
+        file.write(reinterpret_cast<const char *>(&pixel), 3);     //R, G, B in memory order
+    }
+    return static_cast<bool>(file);
+}
+
+static bool acquireTarget(SDL_Window *window, Target &target) {
+    target.release();
+    target.window = SDL_GetWindowSurface(window);
+    if (!target.window) {
+        return false;
+    }
+
+    //XRGB8888 has the same layout, the renderer's alpha byte is ignored
+    Uint32 format = target.window->format->format;
+    if (format != SDL_PIXELFORMAT_ARGB8888 && format != SDL_PIXELFORMAT_RGB888) {
+        target.shadow = SDL_CreateRGBSurfaceWithFormat(0, target.window->w, target.window->h, 32, SDL_PIXELFORMAT_ARGB8888);
+        return target.shadow != nullptr;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t scale = 10;
+    bool integerScale = true;
+    double cpuHz = 700.0;
+    const char *rom = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--scale") == 0 && i + 1 < argc) {
+            scale = static_cast<uint32_t>(std::clamp(std::atoi(argv[++i]), 1, 60));
+        } else if (std::strcmp(argv[i], "--stretch") == 0) {
+            integerScale = false;
+        } else if (std::strcmp(argv[i], "--hz") == 0 && i + 1 < argc) {
+            cpuHz = std::max(60.0, std::atof(argv[++i]));
+        } else {
+            rom = argv[i];
+        }
+    }
+    if (!rom) {
+        std::cerr << "Usage : " << argv[0] << " [--scale N] [--stretch] [--hz N] rom" << std::endl;
+        return 1;
+    }
+
+    Chip8 chip8;
+    if (!chip8.loadROM(rom)) {
+        std::cerr << "Failed to load ROM : " << rom << std::endl;
+        return 1;
+    }
+
+    //Same ini as chip8emu, next to the binary
+    auto configPath = std::filesystem::path(argv[0]).parent_path();
+    configPath += configPath.preferred_separator;
+    configReader config(configPath.string());
+    const EmuSettings &settings = config.getSettings();
+
+    SDL_SetMainReady();
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        std::cerr << "Could not initialise SDL video : " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    SDL_Window *window = SDL_CreateWindow("CHIP8-Emu (software)", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+                                          static_cast<int>(VIDEO_WIDTH * scale), static_cast<int>(VIDEO_HEIGHT * scale),
+                                          SDL_WINDOW_RESIZABLE);
+    Target target;
+    if (!window || !acquireTarget(window, target)) {
+        std::cerr << "Could not create a software window : " << SDL_GetError() << std::endl;
+        SDL_Quit();
+        return 1;
+    }
+
+    auto fitWindow = [&]() {
+        auto fitted = std::make_unique<SoftRenderer>(static_cast<uint32_t>(target.window->w),
+                                                     static_cast<uint32_t>(target.window->h), integerScale);
+        fitted->setPalette(toARGB(settings.theme[1]), toARGB(settings.theme[0]));
+        return fitted;
+    };
+    auto renderer = fitWindow();
+    std::cout << "Software Renderer : " << renderer->outputWidth() << "x" << renderer->outputHeight() << ", "
+              << simdName(renderer->simdLevel()) << (target.shadow ? ", blitted" : "") << std::endl;
+
+    FramePacer pacer(std::chrono::microseconds(200));
+    uint64_t presents = 0;
+    uint32_t screenshots = 0;
+    double renderNanos = 0.0;
+
+    //Whole instructions per 60 Hz frame, the remainder carried over
+    const double perFrame = cpuHz / 60.0;
+    double owed = 0.0;
+
+    const auto period = std::chrono::duration_cast<FramePacer::clock::duration>(std::chrono::duration<double>(1.0 / 60.0));
+    auto deadline = FramePacer::clock::now();
+    bool running = true;
+    bool redraw = true;
+
+    while (running) {
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+            if (event.type == SDL_QUIT) {
+                running = false;
+            } else if (event.type == SDL_KEYDOWN && event.key.keysym.scancode == SDL_SCANCODE_ESCAPE) {
+                running = false;
+            } else if (event.type == SDL_KEYDOWN && event.key.keysym.scancode == SDL_SCANCODE_RETURN) {
+                chip8.reset();
+            } else if (event.type == SDL_KEYDOWN && event.key.keysym.scancode == SDL_SCANCODE_F12) {
+                std::string path = "chip8soft_" + std::to_string(screenshots++) + ".ppm";
+                std::cout << "Screenshot : " << path << (saveScreenshot(chip8, settings.theme, path) ? "" : " failed")
+                          << std::endl;
+            } else if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
+                //The old surface is invalid after a resize
+                if (!acquireTarget(window, target)) {
+                    running = false;
+                    break;
+                }
+                renderer = fitWindow();
+                redraw = true;
+            } else if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_EXPOSED) {
+                redraw = true;
+            }
+        }
+
+        const Uint8 *keys = SDL_GetKeyboardState(nullptr);
+        for (int k = 0; k < 16; ++k) {
+            chip8.keypad[k] = keys[KEY_MAPPING[k]];
+        }
+
+        owed += perFrame;
+        auto instructions = static_cast<uint32_t>(owed);
+        owed -= instructions;
+        chip8.runFrame(instructions);
+
+        //A static screen costs no fill and no surface update
+        if (chip8.dirtyRows || redraw) {
+            chip8.dirtyRows = 0;
+            redraw = false;
+
+            auto start = std::chrono::steady_clock::now();
+            SDL_Surface *surface = target.drawn();
+            if (SDL_MUSTLOCK(surface)) {
+                SDL_LockSurface(surface);
+            }
+            renderer->render(chip8.display, surface->pixels, static_cast<size_t>(surface->pitch));
+            if (SDL_MUSTLOCK(surface)) {
+                SDL_UnlockSurface(surface);
+            }
+            renderNanos += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+            if (target.shadow) {
+                SDL_BlitSurface(target.shadow, nullptr, target.window, nullptr);
+            }
+            SDL_UpdateWindowSurface(window);
+            ++presents;
+        }
+
+        deadline += period;
+        auto now = FramePacer::clock::now();
+        if (deadline < now - period * 4) {
+            deadline = now;
+        }
+        pacer.waitUntil(deadline);
+    }
+
+    target.release();
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+
+    std::cout << "Software Renderer : " << presents << " presents, "
+              << (presents ? renderNanos / 1000.0 / presents : 0.0) << " us render each | " << pacer.summary() << std::endl;
+    return 0;
+}
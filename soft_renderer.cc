@@ -0,0 +1,145 @@
+#include "soft_renderer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef CHIP8_SIMD_X86
+#include <immintrin.h>
+#endif
+
+// Fill Kernels : runs shorter than a vector finish with one overlapping store
+
+static void fillScalar(uint32_t *dst, size_t count, uint32_t colour) {
+    std::fill_n(dst, count, colour);
+}
+
+#ifdef CHIP8_SIMD_X86
+__attribute__((target("sse2"))) static void fillSse2(uint32_t *dst, size_t count, uint32_t colour) {
+    if (count < 4) {
+        fillScalar(dst, count, colour);
+        return;
+    }
+
+    __m128i v = _mm_set1_epi32(static_cast<int>(colour));
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), v);
+    }
+    if (i < count) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + count - 4), v);
+    }
+}
+
+__attribute__((target("avx2"))) static void fillAvx2(uint32_t *dst, size_t count, uint32_t colour) {
+    if (count < 8) {
+        fillSse2(dst, count, colour);
+        return;
+    }
+
+    __m256i v = _mm256_set1_epi32(static_cast<int>(colour));
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), v);
+    }
+    if (i < count) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + count - 8), v);
+    }
+}
+#endif
+
+SoftRenderer::SoftRenderer(uint32_t width, uint32_t height, bool integerScale)
+    : width(width), height(height), simd(detectSimd()) {
+    uint32_t scale = std::min(width / VIDEO_WIDTH, height / VIDEO_HEIGHT);
+
+    if (integerScale && scale > 0) {
+        scaledWidth = VIDEO_WIDTH * scale;
+        scaledHeight = VIDEO_HEIGHT * scale;
+    } else {
+        scaledWidth = std::min(width, height * 2);
+        scaledHeight = scaledWidth / 2;
+    }
+    originX = (width - scaledWidth) / 2;
+    originY = (height - scaledHeight) / 2;
+
+    for (uint32_t x = 0; x < VIDEO_WIDTH; ++x) {
+        uint32_t start = x * scaledWidth / VIDEO_WIDTH;
+        columns[x] = {originX + start, (x + 1) * scaledWidth / VIDEO_WIDTH - start};
+    }
+    for (uint32_t y = 0; y < VIDEO_HEIGHT; ++y) {
+        uint32_t start = y * scaledHeight / VIDEO_HEIGHT;
+        rows[y] = {originY + start, (y + 1) * scaledHeight / VIDEO_HEIGHT - start};
+    }
+}
+
+SoftRenderer SoftRenderer::forScale(uint32_t scale) {
+    return SoftRenderer(VIDEO_WIDTH * scale, VIDEO_HEIGHT * scale);
+}
+
+void SoftRenderer::setSimd(SimdLevel level) {
+    simd = std::min(level, detectSimd());
+}
+
+void SoftRenderer::fill(uint32_t *dst, size_t count, uint32_t colour) const {
+#ifdef CHIP8_SIMD_X86
+    if (simd == SimdLevel::AVX2) {
+        fillAvx2(dst, count, colour);
+        return;
+    }
+    if (simd == SimdLevel::SSE2) {
+        fillSse2(dst, count, colour);
+        return;
+    }
+#endif
+    fillScalar(dst, count, colour);
+}
+
+/**
+ * Each display row is expanded once, as runs of equal pixels, into the
+ * first output line it covers; the remaining lines of its span are copies
+ */
+void SoftRenderer::render(const uint8_t (&display)[VIDEO_HEIGHT][VIDEO_ROW_BYTES], void *pixels, size_t pitch) const {
+    auto line = [&](uint32_t y) {
+        return reinterpret_cast<uint32_t *>(static_cast<uint8_t *>(pixels) + y * pitch);
+    };
+
+    //Letterbox
+    for (uint32_t y = 0; y < originY; ++y) {
+        fill(line(y), width, background);
+    }
+    for (uint32_t y = originY + scaledHeight; y < height; ++y) {
+        fill(line(y), width, background);
+    }
+
+    for (uint32_t r = 0; r < VIDEO_HEIGHT; ++r) {
+        if (rows[r].length == 0) {
+            continue;
+        }
+
+        uint32_t *dst = line(rows[r].start);
+        uint64_t bits = 0;
+        for (uint32_t b = 0; b < VIDEO_ROW_BYTES; ++b) {
+            bits = (bits << 8) | display[r][b];
+        }
+
+        //Pillarbox, then runs of equal pixels, MSB = leftmost
+        fill(dst, originX, background);
+        fill(dst + originX + scaledWidth, width - originX - scaledWidth, background);
+
+        uint32_t x = 0;
+        while (x < VIDEO_WIDTH) {
+            bool lit = (bits >> (VIDEO_WIDTH - 1 - x)) & 1U;
+            uint32_t end = x + 1;
+            while (end < VIDEO_WIDTH && (((bits >> (VIDEO_WIDTH - 1 - end)) & 1U) == lit)) {
+                ++end;
+            }
+
+            uint32_t start = columns[x].start;
+            fill(dst + start, columns[end - 1].start + columns[end - 1].length - start, lit ? foreground : background);
+            x = end;
+        }
+
+        for (uint32_t i = 1; i < rows[r].length; ++i) {
+            std::memcpy(line(rows[r].start + i), dst, width * sizeof(uint32_t));
+        }
+    }
+}
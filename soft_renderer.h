@@ -0,0 +1,76 @@
+#ifndef SOFT_RENDERER_H
+#define SOFT_RENDERER_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "chip8.h"
+#include "utils/simd.h"
+
+/**
+ * CPU renderer for hosts without usable GL
+ * Scales the packed 1 bpp display into a 32-bit buffer with nearest
+ * neighbour, centred and letterboxed in background colour.
+ * Output pixels are ARGB8888, so an SDL_Surface can be drawn into directly
+ * (render(display, surface->pixels, surface->pitch)).
+ */
+class SoftRenderer {
+   private:
+    struct Span {
+        uint32_t start;
+        uint32_t length;
+    };
+
+    uint32_t width;
+    uint32_t height;
+    uint32_t foreground = 0xFFFFFFFFU;
+    uint32_t background = 0xFF000000U;
+    SimdLevel simd;
+
+    //Output columns / rows covered by each display column / row
+    Span columns[VIDEO_WIDTH];
+    Span rows[VIDEO_HEIGHT];
+    uint32_t originX = 0;
+    uint32_t originY = 0;
+    uint32_t scaledWidth = 0;
+    uint32_t scaledHeight = 0;
+
+    void fill(uint32_t *dst, size_t count, uint32_t colour) const;
+
+   public:
+    /**
+     * integerScale keeps every display pixel the same size (largest whole
+     * factor that fits); otherwise the display is stretched to the largest
+     * 2:1 rectangle and pixel sizes differ by at most one
+     */
+    SoftRenderer(uint32_t width, uint32_t height, bool integerScale = true);
+
+    // Output sized for App::scale, e.g. 10 -> 640x320
+    static SoftRenderer forScale(uint32_t scale);
+
+    void setPalette(uint32_t fg, uint32_t bg) noexcept {
+        foreground = fg;
+        background = bg;
+    }
+
+    // Force a kernel, e.g. to benchmark; levels the CPU lacks fall back
+    void setSimd(SimdLevel level);
+
+    SimdLevel simdLevel() const noexcept {
+        return simd;
+    }
+
+    uint32_t outputWidth() const noexcept {
+        return width;
+    }
+
+    uint32_t outputHeight() const noexcept {
+        return height;
+    }
+
+    // pitch in bytes between output rows, >= width * 4
+    void render(const uint8_t (&display)[VIDEO_HEIGHT][VIDEO_ROW_BYTES], void *pixels, size_t pitch) const;
+};
+
+#endif // SOFT_RENDERER_H
@@ -0,0 +1,208 @@
+#include "state_explorer.h"
+
+#include <atomic>
+#include <thread>
+#include <cstddef>
+#include <algorithm>
+
+#include "vec_env.h"
+#include "utils/hash.h"
+
+void ExplorerReport::print(std::ostream &os) const {
+    os << "States : " << states << (truncated ? " (truncated)" : "") << "\n"
+       << "Transitions : " << transitions << "\n"
+       << "BFS Depth : " << depth << "\n"
+       << "Distinct Framebuffers : " << distinctFramebuffers << "\n"
+       << "Stuck States : " << stuckStates << "\n"
+       << "PC Coverage : " << pcCoverage.count() << " addresses" << std::endl;
+}
+
+StateExplorer::StateExplorer(const ExplorerConfig &cfg) : config(cfg) {
+    if (config.numThreads == 0) {
+        config.numThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+}
+
+// State fields before and after memory[]
+static constexpr size_t HEAD_BYTES = offsetof(Chip8::State, memory);
+static constexpr size_t TAIL_OFFSET = HEAD_BYTES + MEMORY_SIZE;
+static constexpr size_t TAIL_BYTES = sizeof(Chip8::State) - TAIL_OFFSET;
+
+void StateExplorer::Frontier::push(const Chip8::State &state) {
+    const uint8_t *raw = reinterpret_cast<const uint8_t *>(&state);
+    offsets.push_back(bytes.size());
+    bytes.insert(bytes.end(), raw, raw + HEAD_BYTES);
+    bytes.insert(bytes.end(), raw + TAIL_OFFSET, raw + TAIL_OFFSET + TAIL_BYTES);
+
+    for (uint32_t p = 0; p < MEMORY_PAGES; ++p) {
+        if (state.privatePages & (1U << p)) {
+            bytes.insert(bytes.end(), &state.memory[p * MEMORY_PAGE_SIZE], &state.memory[(p + 1) * MEMORY_PAGE_SIZE]);
+        }
+    }
+}
+
+// Only the private pages of memory[] are filled, as restore() reads no others
+void StateExplorer::Frontier::load(size_t idx, Chip8::State &state) const {
+    const uint8_t *src = &bytes[offsets[idx]];
+    uint8_t *raw = reinterpret_cast<uint8_t *>(&state);
+    std::memcpy(raw, src, HEAD_BYTES);
+    std::memcpy(raw + TAIL_OFFSET, src + HEAD_BYTES, TAIL_BYTES);
+    src += HEAD_BYTES + TAIL_BYTES;
+
+    for (uint32_t p = 0; p < MEMORY_PAGES; ++p) {
+        if (state.privatePages & (1U << p)) {
+            std::memcpy(&state.memory[p * MEMORY_PAGE_SIZE], src, MEMORY_PAGE_SIZE);
+            src += MEMORY_PAGE_SIZE;
+        }
+    }
+}
+
+void StateExplorer::Frontier::append(const Frontier &other) {
+    size_t base = bytes.size();
+    for (size_t offset : other.offsets) {
+        offsets.push_back(base + offset);
+    }
+    bytes.insert(bytes.end(), other.bytes.begin(), other.bytes.end());
+}
+
+uint64_t StateExplorer::hashFramebuffer(const Chip8::State &state) const {
+    return hashBytes(state.display, sizeof(state.display));
+}
+
+/**
+ * Registers, stack, timers and the memory delta against the loaded ROM
+ * Unchanged memory words cost a compare and nothing else
+ */
+uint64_t StateExplorer::hashState(const Chip8::State &state, uint64_t frameHash) const {
+    uint64_t h = hashBytes(state.registers, sizeof(state.registers), frameHash);
+    h = hashBytes(state.stack, sizeof(state.stack), h);
+
+    uint64_t scalars = (uint64_t(state.index) << 48) | (uint64_t(state.pc) << 32) |
+                       (uint64_t(state.sp) << 16) | (uint64_t(state.delay_timer) << 8) | state.sound_timer;
+    h = mix64(h ^ scalars);
+
+    if (config.hashRng) {
+        h = mix64(h ^ state.rngState);
+    }
+
+    //Pages never written are identical to the image and skipped entirely
+    uint64_t delta = 0;
+    for (uint32_t p = 0; p < MEMORY_PAGES; ++p) {
+        if (!(state.privatePages & (1U << p))) {
+            continue;
+        }
+
+        for (size_t w = p * MEMORY_PAGE_SIZE / 8; w < (p + 1) * MEMORY_PAGE_SIZE / 8; ++w) {
+            uint64_t cur, base;
+            std::memcpy(&cur, &state.memory[w * 8], 8);
+            std::memcpy(&base, &image->bytes[w * 8], 8);
+
+            if (cur != base) {
+                delta += mix64((cur ^ base) + w * 0x9E3779B97F4A7C15ULL);
+            }
+        }
+    }
+    return mix64(h ^ delta);
+}
+
+ExplorerReport StateExplorer::explore(const Chip8 &root) {
+    constexpr size_t ACTIONS = 16 - NO_ACTION;
+    ExplorerReport report;
+
+    image = &root.memoryImage();
+
+    //Every expanded state is in visited (threads may overshoot maxStates by one each), so
+    //transitions, and with them distinct framebuffers, stay under expanded * ACTIONS
+    ConcurrentHashSet visited(config.maxStates + config.numThreads);
+    ConcurrentHashSet framebuffers((config.maxStates + config.numThreads) * ACTIONS + 1);
+
+    auto rootState = std::make_unique<Chip8::State>();
+    root.clone(*rootState);
+    visited.insert(hashState(*rootState, hashFramebuffer(*rootState)));
+    framebuffers.insert(hashFramebuffer(*rootState));
+
+    Frontier frontier;
+    frontier.push(*rootState);
+
+    std::vector<std::bitset<END_ADDRESS + 1>> coverage(config.numThreads);
+    std::atomic<uint64_t> transitions{0};
+    std::atomic<uint64_t> stuck{0};
+    std::atomic<bool> full{false};
+
+    while (frontier.size() > 0 && report.depth < config.maxDepth) {
+        std::atomic<size_t> nextIdx{0};
+        std::vector<Frontier> next(config.numThreads);
+
+        auto worker = [&](size_t t) {
+            //Own machine on the shared image, the root's coverage map and pool slab stay untouched
+            Chip8 env;
+            env.useImage(root.sharedImage());
+            auto state = std::make_unique<Chip8::State>();
+            auto out = std::make_unique<Chip8::State>();
+
+            for (size_t i = nextIdx.fetch_add(1); i < frontier.size(); i = nextIdx.fetch_add(1)) {
+                frontier.load(i, *state);
+                uint64_t selfHash = hashState(*state, hashFramebuffer(*state));
+                bool isStuck = true;
+
+                for (int action = NO_ACTION; action < 16; ++action) {
+                    env.restore(*state);
+                    applyAction(env, action);
+
+                    for (uint32_t f = 0; f < config.framesPerStep; ++f) {
+                        for (uint32_t n = 0; n < config.instructionsPerFrame; ++n) {
+                            coverage[t].set(env.getPC() & END_ADDRESS);
+                            env.cycle();
+                        }
+                        env.clock_tick();
+                    }
+
+                    env.clone(*out);
+                    uint64_t frameHash = hashFramebuffer(*out);
+                    uint64_t stateHash = hashState(*out, frameHash);
+                    framebuffers.insert(frameHash);
+                    transitions.fetch_add(1, std::memory_order_relaxed);
+
+                    if (stateHash != selfHash) {
+                        isStuck = false;
+                    }
+
+                    if (visited.size() >= config.maxStates) {
+                        full.store(true, std::memory_order_relaxed);
+                    } else if (visited.insert(stateHash)) {
+                        next[t].push(*out);
+                    }
+                }
+
+                if (isStuck) {
+                    stuck.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (size_t t = 1; t < config.numThreads; ++t) {
+            threads.emplace_back(worker, t);
+        }
+        worker(0);
+        for (auto &t : threads) {
+            t.join();
+        }
+
+        frontier = Frontier();
+        for (const auto &n : next) {
+            frontier.append(n);
+        }
+        ++report.depth;
+    }
+
+    for (const auto &c : coverage) {
+        report.pcCoverage |= c;
+    }
+    report.states = visited.size();
+    report.transitions = transitions.load();
+    report.distinctFramebuffers = framebuffers.size();
+    report.stuckStates = stuck.load();
+    report.truncated = full.load() || frontier.size() > 0;
+    return report;
+}
@@ -0,0 +1,68 @@
+#ifndef STATE_EXPLORER_H
+#define STATE_EXPLORER_H
+
+#include <bitset>
+#include <vector>
+#include <memory>
+#include <ostream>
+
+#include "chip8.h"
+#include "utils/concurrentHashSet.h"
+
+struct ExplorerConfig {
+    size_t numThreads = 0;              // 0 = hardware_concurrency
+    size_t maxStates = 50000;           // Frontier entries hold registers, display and written pages only
+    uint32_t maxDepth = 1000;
+    uint32_t instructionsPerFrame = 10;
+    uint32_t framesPerStep = 4;         // Frames a key is held per transition
+    bool hashRng = false;               // Treat states differing only in RNG as distinct
+};
+
+struct ExplorerReport {
+    uint64_t states = 0;
+    uint64_t transitions = 0;
+    uint64_t distinctFramebuffers = 0;
+    uint64_t stuckStates = 0;           // Every input leads back to the same state
+    uint32_t depth = 0;
+    bool truncated = false;             // Stopped at maxStates / maxDepth
+    std::bitset<END_ADDRESS + 1> pcCoverage;
+
+    void print(std::ostream &os) const;
+};
+
+/**
+ * Breadth-first search over (state, key) transitions
+ * Visited states and framebuffers are deduplicated by 64-bit hash
+ */
+class StateExplorer {
+   private:
+    /**
+     * One BFS level, each state packed as its fields outside memory[]
+     * followed by its private pages (~340 bytes + 256 per written page)
+     */
+    struct Frontier {
+        std::vector<uint8_t> bytes;
+        std::vector<size_t> offsets;
+
+        void push(const Chip8::State &state);
+        void load(size_t idx, Chip8::State &state) const;
+        void append(const Frontier &other);
+
+        size_t size() const noexcept {
+            return offsets.size();
+        }
+    };
+
+    ExplorerConfig config;
+    const MemoryImage *image = nullptr;     // ROM the memory delta is taken against
+
+    uint64_t hashFramebuffer(const Chip8::State &state) const;
+    uint64_t hashState(const Chip8::State &state, uint64_t frameHash) const;
+
+   public:
+    explicit StateExplorer(const ExplorerConfig &cfg);
+
+    ExplorerReport explore(const Chip8 &root);
+};
+
+#endif // STATE_EXPLORER_H
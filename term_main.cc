@@ -0,0 +1,180 @@
+/**
+ * Terminal front end for SSH-only hosts
+ * chip8term [--braille] [--hz N] rom
+ * Keys as in the window (1234 / QWER / ASDF / ZXCV), Enter resets, Esc quits.
+ * Terminals report presses but not releases, so a key counts as held
+ * until KEY_HOLD frames pass without it repeating.
+ */
+
+#include <iostream>
+#include <cstring>
+#include <cctype>
+#include <cstdlib>
+#include <csignal>
+#include <string>
+#include <chrono>
+#include <algorithm>
+
+#include <termios.h>
+#include <unistd.h>
+
+#include "chip8.h"
+#include "terminal_renderer.h"
+#include "utils/framePacer.h"
+
+static constexpr int KEY_HOLD = 8;
+static constexpr char KEY_MAPPING[16] = {
+    'x', '1', '2', '3',
+    'q', 'w', 'e', 'a',
+    's', 'd', 'z', 'c',
+    '4', 'r', 'f', 'v',
+};
+
+static termios savedTermios;
+static volatile std::sig_atomic_t stopRequested = 0;
+
+static void writeAll(const char *data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::write(STDOUT_FILENO, data, size);
+        if (n <= 0) {
+            return;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+}
+
+//Alternate screen and hidden cursor, restored on exit
+static void restoreTerminal() {
+    static bool restored = false;
+    if (restored) {
+        return;
+    }
+    restored = true;
+
+    static const char leave[] = "\x1b[?25h\x1b[?1049l";
+    writeAll(leave, sizeof(leave) - 1);
+    tcsetattr(STDIN_FILENO, TCSAFLUSH, &savedTermios);
+}
+
+static bool enterRawMode() {
+    if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &savedTermios) != 0) {
+        return false;
+    }
+
+    termios raw = savedTermios;
+    raw.c_lflag &= ~static_cast<tcflag_t>(ICANON | ECHO | ISIG | IEXTEN);
+    raw.c_iflag &= ~static_cast<tcflag_t>(IXON | ICRNL);
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw) != 0) {
+        return false;
+    }
+
+    static const char enter[] = "\x1b[?1049h\x1b[?25l\x1b[2J";
+    writeAll(enter, sizeof(enter) - 1);
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    auto mode = TerminalRenderer::Mode::HALF_BLOCK;
+    double cpuHz = 700.0;
+    const char *rom = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--braille") == 0) {
+            mode = TerminalRenderer::Mode::BRAILLE;
+        } else if (std::strcmp(argv[i], "--hz") == 0 && i + 1 < argc) {
+            cpuHz = std::max(60.0, std::atof(argv[++i]));
+        } else {
+            rom = argv[i];
+        }
+    }
+    if (!rom) {
+        std::cerr << "Usage : " << argv[0] << " [--braille] [--hz N] rom" << std::endl;
+        return 1;
+    }
+
+    Chip8 chip8;
+    if (!chip8.loadROM(rom)) {
+        std::cerr << "Failed to load ROM : " << rom << std::endl;
+        return 1;
+    }
+
+    if (!enterRawMode()) {
+        std::cerr << "stdin is not a terminal" << std::endl;
+        return 1;
+    }
+    std::atexit(restoreTerminal);
+    std::signal(SIGTERM, [](int) { stopRequested = 1; });
+    std::signal(SIGHUP, [](int) { stopRequested = 1; });
+
+    TerminalRenderer renderer(mode);
+    FramePacer pacer(std::chrono::microseconds(0));
+    std::string out;
+    int held[16]{};
+
+    //Whole instructions per 60 Hz frame, the remainder carried over
+    const double perFrame = cpuHz / 60.0;
+    double owed = 0.0;
+
+    const auto period = std::chrono::duration_cast<FramePacer::clock::duration>(std::chrono::duration<double>(1.0 / 60.0));
+    auto deadline = FramePacer::clock::now();
+    bool running = true;
+
+    while (running && !stopRequested) {
+        //Input
+        char buffer[64];
+        ssize_t n = ::read(STDIN_FILENO, buffer, sizeof(buffer));
+        for (ssize_t i = 0; i < n; ++i) {
+            char key = static_cast<char>(std::tolower(static_cast<unsigned char>(buffer[i])));
+            if (key == 0x1b || key == 0x03) {
+                //Esc, or Ctrl-C since ISIG is off; arrow keys arrive as Esc [ x, so Esc must be alone
+                if (key == 0x03 || i + 1 == n) {
+                    running = false;
+                }
+                i = n;
+            } else if (key == '\r' || key == '\n') {
+                chip8.reset();
+                renderer.invalidate();
+            } else {
+                const char *hit = std::find(KEY_MAPPING, KEY_MAPPING + 16, key);
+                if (hit != KEY_MAPPING + 16) {
+                    held[hit - KEY_MAPPING] = KEY_HOLD;
+                }
+            }
+        }
+        for (int k = 0; k < 16; ++k) {
+            chip8.keypad[k] = held[k] > 0;
+            if (held[k] > 0) {
+                --held[k];
+            }
+        }
+
+        owed += perFrame;
+        auto instructions = static_cast<uint32_t>(owed);
+        owed -= instructions;
+        chip8.runFrame(instructions);
+
+        //Only changed cells, nothing at all for a static screen
+        uint32_t dirty = chip8.dirtyRows;
+        chip8.dirtyRows = 0;
+        out.clear();
+        if (renderer.update(chip8.display, out, dirty) > 0) {
+            writeAll(out.data(), out.size());
+        }
+
+        deadline += period;
+        auto now = FramePacer::clock::now();
+        if (deadline < now - period * 4) {
+            deadline = now;
+        }
+        pacer.waitUntil(deadline);
+    }
+
+    restoreTerminal();
+    std::cerr << "Terminal : " << renderer.updateCount() << " frames, "
+              << (renderer.updateCount() ? renderer.bytesWritten() / renderer.updateCount() : 0) << " bytes/frame | "
+              << pacer.summary() << std::endl;
+    return 0;
+}
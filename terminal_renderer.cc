@@ -0,0 +1,113 @@
+#include "terminal_renderer.h"
+
+//Unchanged cells this short between two changed runs are rewritten instead of skipped with a cursor move
+static constexpr uint32_t MAX_GAP = 2;
+
+TerminalRenderer::TerminalRenderer(Mode mode, uint32_t originRow, uint32_t originColumn)
+    : mode(mode), originRow(originRow), originColumn(originColumn) {
+    if (mode == Mode::BRAILLE) {
+        cellColumns = VIDEO_WIDTH / 2;
+        pixelRows = 4;
+    } else {
+        cellColumns = VIDEO_WIDTH;
+        pixelRows = 2;
+    }
+    cellRows = VIDEO_HEIGHT / pixelRows;
+}
+
+static inline uint32_t pixel(const uint8_t (&display)[VIDEO_HEIGHT][VIDEO_ROW_BYTES], uint32_t y, uint32_t x) {
+    return (display[y][x / 8] >> (7 - x % 8)) & 1U;
+}
+
+uint8_t TerminalRenderer::cellAt(const uint8_t (&display)[VIDEO_HEIGHT][VIDEO_ROW_BYTES], uint32_t row,
+                                 uint32_t column) const {
+    if (mode == Mode::HALF_BLOCK) {
+        uint32_t y = row * 2;
+        return static_cast<uint8_t>(pixel(display, y, column) | (pixel(display, y + 1, column) << 1));
+    }
+
+    //Braille dots 1-3 and 4-6 run down the two columns, 7 and 8 sit below them
+    static constexpr uint8_t DOTS[4][2] = {{0x01, 0x08}, {0x02, 0x10}, {0x04, 0x20}, {0x40, 0x80}};
+    uint8_t dots = 0;
+    for (uint32_t j = 0; j < 4; ++j) {
+        for (uint32_t i = 0; i < 2; ++i) {
+            if (pixel(display, row * 4 + j, column * 2 + i)) {
+                dots |= DOTS[j][i];
+            }
+        }
+    }
+    return dots;
+}
+
+void TerminalRenderer::appendGlyph(std::string &out, uint8_t cell) const {
+    if (mode == Mode::HALF_BLOCK) {
+        static const char *const BLOCKS[4] = {" ", "▀", "▄", "█"};
+        out += BLOCKS[cell & 3U];
+        return;
+    }
+
+    //U+2800 + dots, always three UTF-8 bytes
+    uint32_t cp = 0x2800U + cell;
+    out += static_cast<char>(0xE0 | (cp >> 12));
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+}
+
+void TerminalRenderer::appendMove(std::string &out, uint32_t row, uint32_t column) const {
+    out += "\x1b[";
+    out += std::to_string(originRow + row);
+    out += ';';
+    out += std::to_string(originColumn + column);
+    out += 'H';
+}
+
+size_t TerminalRenderer::update(const uint8_t (&display)[VIDEO_HEIGHT][VIDEO_ROW_BYTES], std::string &out,
+                                uint32_t dirtyRows) {
+    const size_t before = out.size();
+    const uint32_t rowMask = (1U << pixelRows) - 1;
+
+    if (!valid) {
+        dirtyRows = ~0U;
+    }
+
+    for (uint32_t r = 0; r < cellRows; ++r) {
+        if (valid && !((dirtyRows >> (r * pixelRows)) & rowMask)) {
+            continue;
+        }
+
+        uint8_t next[MAX_COLUMNS];
+        for (uint32_t c = 0; c < cellColumns; ++c) {
+            next[c] = cellAt(display, r, c);
+        }
+
+        //Runs of changed cells, joined across short gaps; the cursor is left after each run
+        uint32_t c = 0;
+        while (c < cellColumns) {
+            if (valid && next[c] == cells[r][c]) {
+                ++c;
+                continue;
+            }
+
+            uint32_t end = c + 1;
+            uint32_t last = c;
+            while (end < cellColumns && end - last <= MAX_GAP + 1) {
+                if (!valid || next[end] != cells[r][end]) {
+                    last = end;
+                }
+                ++end;
+            }
+
+            appendMove(out, r, c);
+            for (uint32_t i = c; i <= last; ++i) {
+                appendGlyph(out, next[i]);
+                cells[r][i] = next[i];
+            }
+            c = last + 1;
+        }
+    }
+
+    valid = true;
+    ++updates;
+    bytes += out.size() - before;
+    return out.size() - before;
+}
@@ -0,0 +1,75 @@
+#ifndef TERMINAL_RENDERER_H
+#define TERMINAL_RENDERER_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#include "chip8.h"
+
+/**
+ * Draws the display in a terminal with Unicode block characters
+ * HALF_BLOCK packs 1x2 pixels per cell (64x16 cells), BRAILLE 2x4 (32x8).
+ * Cells are diffed against the previous frame and only changed runs are
+ * written, each behind one cursor move, so an unchanged frame costs
+ * nothing. Output is UTF-8 with VT100 escapes, nothing is written directly.
+ */
+class TerminalRenderer {
+   public:
+    enum class Mode { HALF_BLOCK, BRAILLE };
+
+    static constexpr uint32_t MAX_COLUMNS = VIDEO_WIDTH;
+    static constexpr uint32_t MAX_ROWS = VIDEO_HEIGHT / 2;
+
+    // Cells are placed from originRow / originColumn, 1-based like VT100
+    explicit TerminalRenderer(Mode mode = Mode::HALF_BLOCK, uint32_t originRow = 1, uint32_t originColumn = 1);
+
+    uint32_t columns() const noexcept {
+        return cellColumns;
+    }
+
+    uint32_t rows() const noexcept {
+        return cellRows;
+    }
+
+    // Next update() repaints every cell, e.g. after the terminal was cleared
+    void invalidate() noexcept {
+        valid = false;
+    }
+
+    /**
+     * Appends the escapes that bring the terminal to display; returns bytes appended
+     * dirtyRows (bit n = display row n) limits the rows compared
+     */
+    size_t update(const uint8_t (&display)[VIDEO_HEIGHT][VIDEO_ROW_BYTES], std::string &out, uint32_t dirtyRows = ~0U);
+
+    // Bytes and updates since construction, for bytes per frame
+    uint64_t bytesWritten() const noexcept {
+        return bytes;
+    }
+
+    uint64_t updateCount() const noexcept {
+        return updates;
+    }
+
+   private:
+    Mode mode;
+    uint32_t originRow;
+    uint32_t originColumn;
+    uint32_t cellColumns;
+    uint32_t cellRows;
+    uint32_t pixelRows;         //Display rows per cell row
+
+    //Cell pattern : half block top | bottom << 1, braille dot bits
+    uint8_t cells[MAX_ROWS][MAX_COLUMNS]{};
+    bool valid = false;
+
+    uint64_t bytes = 0;
+    uint64_t updates = 0;
+
+    uint8_t cellAt(const uint8_t (&display)[VIDEO_HEIGHT][VIDEO_ROW_BYTES], uint32_t row, uint32_t column) const;
+    void appendGlyph(std::string &out, uint8_t cell) const;
+    void appendMove(std::string &out, uint32_t row, uint32_t column) const;
+};
+
+#endif // TERMINAL_RENDERER_H
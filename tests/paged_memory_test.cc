@@ -0,0 +1,106 @@
+/**
+ * Copy-on-write faults must not allocate
+ * After warm-up (pool, image, states), machines borrowed from a
+ * MachinePool run a ROM that writes to most pages, are cloned and
+ * restored, and the process-wide operator new count must not move.
+ * Private pages must all come from the pool's slab.
+ */
+
+#include <iostream>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "chip8.h"
+#include "machine_pool.h"
+
+static std::atomic<uint64_t> allocations{0};
+
+void *operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    std::free(p);
+}
+
+// Stores V0 at 0x300, 0x380 ... 0xF80 (pages 3-15), forever
+static const uint8_t ROM[] = {
+    0x60, 0x00,     // 200: LD V0, 0
+    0xA3, 0x00,     // 202: LD I, 0x300
+    0x61, 0x80,     // 204: LD V1, 0x80
+    0xF0, 0x55,     // 206: LD [I], V0
+    0xF1, 0x1E,     // 208: ADD I, V1
+    0x70, 0x01,     // 20A: ADD V0, 1
+    0x30, 0x1A,     // 20C: SE V0, 26
+    0x12, 0x06,     // 20E: JP 0x206
+    0x12, 0x00,     // 210: JP 0x200
+};
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+    if (!ok) {
+        std::cerr << "FAIL : " << what << std::endl;
+        ++failures;
+    }
+}
+
+int main() {
+    constexpr size_t MACHINES = 8;
+    constexpr int ROUNDS = 100;
+
+    //Warm-up : everything that may allocate
+    constexpr size_t WRITTEN_PAGES = 13;
+    MachinePool pool(MACHINES, WRITTEN_PAGES);
+    auto image = Chip8::makeImage(ROM, sizeof(ROM));
+    std::vector<Chip8 *> machines(MACHINES);
+    std::vector<Chip8::State> states(MACHINES);
+    check(image != nullptr, "image");
+
+    const uint64_t before = allocations.load();
+
+    for (int round = 0; round < ROUNDS; ++round) {
+        for (size_t i = 0; i < MACHINES; ++i) {
+            machines[i] = pool.borrow();
+            machines[i]->useImage(image);
+            machines[i]->reset();
+            machines[i]->runFrame(200);
+            machines[i]->clone(states[i]);
+        }
+
+        //Restore each machine from its neighbour's state : pages shared again, then faulted again
+        for (size_t i = 0; i < MACHINES; ++i) {
+            machines[i]->restore(states[(i + 1) % MACHINES]);
+            machines[i]->runFrame(200);
+        }
+
+        if (round == ROUNDS - 1) {
+            check(pool.pageSlab().pagesInUse() == MACHINES * WRITTEN_PAGES, "one slab page per written page");
+    check(pool.pageSlab().capacity() == MACHINES * WRITTEN_PAGES, "slab did not grow");
+        }
+
+        for (Chip8 *machine : machines) {
+            pool.giveBack(machine);
+        }
+    }
+
+    const uint64_t after = allocations.load();
+    check(states[0].privatePages == 0xFFF8, "ROM writes pages 3-15");
+    check(pool.pageSlab().pagesInUse() == MACHINES * WRITTEN_PAGES, "one slab page per written page");
+    check(pool.pageSlab().capacity() == MACHINES * WRITTEN_PAGES, "slab did not grow");
+    check(after == before, "no allocation after warm-up");
+
+    std::cout << "PagedMemory : " << after - before << " allocations in " << ROUNDS * MACHINES << " machine runs"
+              << std::endl;
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
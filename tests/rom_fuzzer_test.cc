@@ -0,0 +1,87 @@
+/**
+ * Inputs that fault or reach new coverage must be kept
+ * Only the input script is mutated, over a ROM where key 5 leads to a
+ * stack overflow and key 7 to a loop that is otherwise never reached.
+ * The fuzzer must report the fault with a script that reproduces it and
+ * grow its corpus; over a ROM that ignores input it must keep nothing.
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <cstdlib>
+
+#include "rom_fuzzer.h"
+#include "vec_env.h"
+
+static const std::vector<uint8_t> KEYED_ROM = {
+    0x62, 0x05,     // 200: LD V2, 5
+    0xE2, 0x9E,     // 202: SKP V2
+    0x12, 0x08,     // 204: JP 0x208
+    0x12, 0x10,     // 206: JP 0x210
+    0x63, 0x07,     // 208: LD V3, 7
+    0xE3, 0x9E,     // 20A: SKP V3
+    0x12, 0x00,     // 20C: JP 0x200
+    0x12, 0x20,     // 20E: JP 0x220
+    0x22, 0x10,     // 210: CALL 0x210, overflows the stack
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x12, 0x20,     // 220: JP 0x220
+};
+
+static const std::vector<uint8_t> DEAF_ROM = {
+    0x70, 0x01,     // 200: ADD V0, 1
+    0x12, 0x00,     // 202: JP 0x200
+};
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+    if (!ok) {
+        std::cerr << "FAIL : " << what << std::endl;
+        ++failures;
+    }
+}
+
+// Same schedule as RomFuzzer::fuzzThread
+static uint8_t replay(const FuzzInput &input, const FuzzerConfig &config) {
+    Chip8 env;
+    env.loadROM(input.rom.data(), input.rom.size());
+
+    auto event = input.script.begin();
+    for (uint32_t f = 0; f < config.framesPerExec && !env.getFaults(); ++f) {
+        for (; event != input.script.end() && event->frame <= f; ++event) {
+            applyAction(env, event->key);
+        }
+        env.runFrame(config.instructionsPerFrame);
+    }
+    return env.getFaults();
+}
+
+int main() {
+    FuzzerConfig config;
+    config.numThreads = 1;
+    config.executions = 2000;
+    config.mutateRom = false;
+
+    FuzzReport keyed = RomFuzzer(config).run(KEYED_ROM);
+    keyed.print(std::cout);
+
+    check(keyed.crashCount > 0, "key 5 faults");
+    check(!keyed.crashes.empty(), "faulting input kept");
+    check(keyed.corpusSize > 1, "key 7 coverage kept in the corpus");
+
+    for (const auto &crash : keyed.crashes) {
+        const auto &script = crash.second.script;
+        check(crash.first & FAULT_STACK_OVERFLOW, "fault is the stack overflow");
+        check(std::any_of(script.begin(), script.end(), [](const InputEvent &e) { return e.key == 5; }),
+              "faulting script presses key 5");
+        check(replay(crash.second, config) == crash.first, "kept input reproduces its fault");
+    }
+
+    FuzzReport deaf = RomFuzzer(config).run(DEAF_ROM);
+    check(deaf.crashCount == 0, "input-independent ROM never faults");
+    check(deaf.corpusSize == 1, "input-independent ROM keeps only the seed");
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,94 @@
+/**
+ * StateExplorer counts must not depend on thread count or scheduling
+ * A ROM with a known state space is explored to exhaustion with one and
+ * with several threads; the reports must match each other and the ROM.
+ * The root machine, and the coverage map attached to it, must be left alone.
+ */
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+
+#include "chip8.h"
+#include "state_explorer.h"
+
+// Draws a dot at (V0, 0); while key 5 is held it moves right, wrapping after x = 7
+static const uint8_t ROM[] = {
+    0xA2, 0x20,     // 200: LD I, 0x220
+    0x60, 0x00,     // 202: LD V0, 0
+    0x61, 0x00,     // 204: LD V1, 0
+    0xD0, 0x11,     // 206: DRW V0, V1, 1
+    0x62, 0x05,     // 208: LD V2, 5
+    0xE2, 0xA1,     // 20A: SKNP V2
+    0x12, 0x12,     // 20C: JP 0x212
+    0x12, 0x08,     // 20E: JP 0x208
+    0x00, 0x00,     // 210:
+    0xD0, 0x11,     // 212: DRW V0, V1, 1 (erase)
+    0x70, 0x01,     // 214: ADD V0, 1
+    0x40, 0x08,     // 216: SNE V0, 8
+    0x60, 0x00,     // 218: LD V0, 0
+    0x12, 0x06,     // 21A: JP 0x206
+    0x00, 0x00,     // 21C:
+    0x00, 0x00,     // 21E:
+    0x80,           // 220: sprite, one pixel
+};
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+    if (!ok) {
+        std::cerr << "FAIL : " << what << std::endl;
+        ++failures;
+    }
+}
+
+static ExplorerReport explore(const Chip8 &root, size_t threads, size_t maxStates) {
+    ExplorerConfig config;
+    config.numThreads = threads;
+    config.maxStates = maxStates;
+    return StateExplorer(config).explore(root);
+}
+
+int main() {
+    Chip8 root;
+    root.useImage(Chip8::makeImage(ROM, sizeof(ROM)));
+    root.reset();
+    root.runFrame(10);
+
+    std::vector<uint8_t> coverageMap(COVERAGE_MAP_SIZE, 0);
+    root.setCoverageMap(coverageMap.data());
+    const uint16_t rootPc = root.getPC();
+
+    ExplorerReport single = explore(root, 1, 50000);
+    single.print(std::cout);
+
+    check(!single.truncated, "state space explored to exhaustion");
+    check(single.distinctFramebuffers == 9, "8 dot positions and the blank screen mid-move");
+    check(single.transitions == single.states * 17, "every state expanded under all 17 inputs");
+    check(single.pcCoverage.count() == 10, "every instruction of the loop at 0x206");
+
+    for (size_t threads : {2, 4, 8}) {
+        for (int run = 0; run < 3; ++run) {
+            ExplorerReport multi = explore(root, threads, 50000);
+            check(multi.states == single.states, "states independent of threads");
+            check(multi.transitions == single.transitions, "transitions independent of threads");
+            check(multi.distinctFramebuffers == single.distinctFramebuffers, "framebuffers independent of threads");
+            check(multi.stuckStates == single.stuckStates, "stuck states independent of threads");
+            check(multi.depth == single.depth, "depth independent of threads");
+            check(multi.pcCoverage == single.pcCoverage, "coverage independent of threads");
+        }
+    }
+
+    ExplorerReport capped = explore(root, 4, single.states / 2);
+    check(capped.truncated, "maxStates truncates");
+    check(capped.states <= single.states / 2 + 4, "maxStates overshoot bounded by thread count");
+
+    bool mapUntouched = true;
+    for (uint8_t hits : coverageMap) {
+        mapUntouched = mapUntouched && hits == 0;
+    }
+    check(mapUntouched, "root coverage map untouched");
+    check(root.getPC() == rootPc, "root machine untouched");
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,60 @@
+/**
+ * TreeSearch must find the one winning first input of a tiny ROM
+ * The ROM waits for a key; only the winning key writes 100 to the
+ * reward byte, any other key locks it up. Every thread count must
+ * pick the winning key and leave the root machine untouched.
+ */
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+
+#include "chip8.h"
+#include "tree_search.h"
+
+static std::vector<uint8_t> makeRom(uint8_t winningKey) {
+    return {
+        0xF0, 0x0A,                 // 200: LD V0, K
+        0x30, winningKey,           // 202: SE V0, winningKey
+        0x12, 0x04,                 // 204: JP 0x204
+        0xA3, 0x00,                 // 206: LD I, 0x300
+        0x60, 0x64,                 // 208: LD V0, 100
+        0xF0, 0x55,                 // 20A: LD [I], V0
+        0x12, 0x0C,                 // 20C: JP 0x20C
+    };
+}
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+    if (!ok) {
+        std::cerr << "FAIL : " << what << std::endl;
+        ++failures;
+    }
+}
+
+int main() {
+    for (uint8_t key : {3, 9, 12}) {
+        std::vector<uint8_t> rom = makeRom(key);
+        Chip8 root;
+        root.loadROM(rom.data(), rom.size());
+        root.runFrame(10);
+
+        for (size_t threads : {1, 4}) {
+            TreeSearchConfig config;
+            config.numThreads = threads;
+            config.iterations = 300;
+            config.rewardAddresses = {{0x300, 1.0f}};
+
+            int action = TreeSearch(config).search(root);
+            std::cout << "Winning key " << int(key) << ", " << threads << " threads : search picked " << action
+                      << std::endl;
+            check(action == key, "search picks the winning key");
+        }
+
+        check(root.getPC() == 0x200, "root still waiting for a key");
+        check(root.peek(0x300) == 0 && root.privatePages() == 0, "root memory untouched");
+    }
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
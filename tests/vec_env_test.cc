@@ -0,0 +1,116 @@
+/**
+ * VecEnv steps, rewards and resets
+ * Every env runs a ROM that counts key 5 presses into 0x300, the reward
+ * byte. Envs given the same actions must score the same, whatever the
+ * thread count; reset envs must start over; a missing ROM must throw.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+#include "vec_env.h"
+
+static const uint8_t ROM[] = {
+    0xA3, 0x00,     // 200: LD I, 0x300
+    0x60, 0x00,     // 202: LD V0, 0
+    0x62, 0x05,     // 204: LD V2, 5
+    0xE2, 0xA1,     // 206: SKNP V2
+    0x70, 0x01,     // 208: ADD V0, 1
+    0xF0, 0x55,     // 20A: LD [I], V0
+    0x12, 0x04,     // 20C: JP 0x204
+};
+
+static const char *ROM_PATH = "vec_env_test.ch8";
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+    if (!ok) {
+        std::cerr << "FAIL : " << what << std::endl;
+        ++failures;
+    }
+}
+
+// Even envs hold key 5, odd envs press nothing
+static std::vector<float> run(size_t numEnvs, size_t numThreads, int steps, std::vector<float> &resetRewards) {
+    VecEnvConfig config;
+    config.romPath = ROM_PATH;
+    config.numEnvs = numEnvs;
+    config.numThreads = numThreads;
+    config.rewardAddresses = {{0x300, 1.0f}};
+    VecEnv env(config);
+
+    std::vector<int> actions(numEnvs);
+    for (size_t i = 0; i < numEnvs; ++i) {
+        actions[i] = i % 2 ? NO_ACTION : 5;
+    }
+
+    std::vector<float> total(numEnvs, 0.0f);
+    for (int s = 0; s < steps; ++s) {
+        env.step(actions.data());
+        for (size_t i = 0; i < numEnvs; ++i) {
+            total[i] += env.reward()[i];
+        }
+    }
+
+    //Reset the first half, then one more step : reset envs score their first step again
+    std::vector<uint8_t> mask(numEnvs, 0);
+    for (size_t i = 0; i < numEnvs / 2; ++i) {
+        mask[i] = 1;
+    }
+    env.reset(mask.data());
+    for (size_t i = 0; i < numEnvs / 2; ++i) {
+        check(env.reward()[i] == 0.0f, "reset clears the reward");
+    }
+    env.step(actions.data());
+    resetRewards.assign(env.reward(), env.reward() + numEnvs);
+    return total;
+}
+
+int main() {
+    {
+        std::ofstream file(ROM_PATH, std::ios::binary);
+        file.write(reinterpret_cast<const char *>(ROM), sizeof(ROM));
+    }
+
+    constexpr size_t ENVS = 64;
+    constexpr int STEPS = 10;
+
+    std::vector<float> firstStep;
+    std::vector<float> oneStep = run(ENVS, 1, 1, firstStep);
+    check(oneStep[0] > 0.0f, "key 5 scores");
+    check(oneStep[1] == 0.0f, "no key scores nothing");
+
+    for (size_t threads : {1, 4, 16}) {
+        std::vector<float> afterReset;
+        std::vector<float> total = run(ENVS, threads, STEPS, afterReset);
+
+        for (size_t i = 0; i < ENVS; ++i) {
+            check(total[i] == total[i % 2], "same actions, same score");
+            if (i < ENVS / 2) {
+                check(afterReset[i] == oneStep[i % 2], "reset env scores its first step again");
+            } else {
+                check(afterReset[i] == afterReset[ENVS / 2 + i % 2], "envs not reset keep counting");
+            }
+        }
+        check(total[0] > oneStep[0], "score accumulates over steps");
+        check(total[1] == 0.0f, "no key never scores");
+    }
+
+    bool threw = false;
+    try {
+        VecEnvConfig config;
+        config.romPath = "does-not-exist.ch8";
+        VecEnv env(config);
+    } catch (const std::runtime_error &) {
+        threw = true;
+    }
+    check(threw, "missing ROM throws");
+
+    std::remove(ROM_PATH);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
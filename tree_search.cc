@@ -0,0 +1,140 @@
+#include "tree_search.h"
+
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <algorithm>
+
+TreeSearch::TreeSearch(const TreeSearchConfig &cfg) : config(cfg) {
+    if (config.numThreads == 0) {
+        config.numThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    config.framesPerAction = std::max(1U, config.framesPerAction);
+}
+
+// Weighted change of the reward bytes since the root
+double TreeSearch::score(const Chip8 &env, const std::vector<uint8_t> &rootValues) const {
+    double value = 0.0;
+
+    for (size_t r = 0; r < config.rewardAddresses.size(); ++r) {
+        const auto &reward = config.rewardAddresses[r];
+        value += reward.scale * (static_cast<int>(env.peek(reward.address)) - rootValues[r]);
+    }
+    return value;
+}
+
+void TreeSearch::searchThread(const Chip8 &rootEnv, uint32_t seed, std::vector<uint64_t> &rootVisits) const {
+    //Per-thread machine on the shared image, every simulation restores the root snapshot into it
+    auto rootState = std::make_unique<Chip8::State>();
+    rootEnv.clone(*rootState);
+    Chip8 env;
+    env.useImage(rootEnv.sharedImage());
+    env.restore(*rootState);
+
+    std::vector<uint8_t> rootValues;
+    for (const auto &r : config.rewardAddresses) {
+        rootValues.push_back(env.peek(r.address));
+    }
+
+    std::minstd_rand rng(seed);
+    std::uniform_int_distribution<int> randomAction(0, NUM_ACTIONS - 1);
+
+    std::vector<Node> nodes;
+    nodes.reserve(1 + static_cast<size_t>(config.iterations) * NUM_ACTIONS);
+    nodes.push_back({-1, -1, NO_ACTION, 0, 0.0});
+
+    auto advance = [&](int action) {
+        applyAction(env, action);
+        for (uint32_t f = 0; f < config.framesPerAction; ++f) {
+            env.runFrame(config.instructionsPerFrame);
+        }
+    };
+
+    for (uint32_t it = 0; it < config.iterations; ++it) {
+        env.restore(*rootState);
+        int32_t node = 0;
+
+        //Selection (UCT)
+        while (nodes[node].firstChild >= 0) {
+            double logN = std::log(static_cast<double>(nodes[node].visits));
+            int32_t best = nodes[node].firstChild;
+            double bestScore = -std::numeric_limits<double>::infinity();
+
+            for (int32_t c = nodes[node].firstChild; c < nodes[node].firstChild + NUM_ACTIONS; ++c) {
+                const Node &child = nodes[c];
+                if (child.visits == 0) {
+                    best = c;
+                    break;
+                }
+                double uct = child.valueSum / child.visits + config.exploration * std::sqrt(logN / child.visits);
+                if (uct > bestScore) {
+                    bestScore = uct;
+                    best = c;
+                }
+            }
+            node = best;
+            advance(nodes[node].action);
+        }
+
+        //Expansion
+        if (node == 0 || nodes[node].visits > 0) {
+            int32_t first = static_cast<int32_t>(nodes.size());
+            for (int a = 0; a < NUM_ACTIONS; ++a) {
+                nodes.push_back({node, -1, a - 1, 0, 0.0});
+            }
+            nodes[node].firstChild = first;
+            node = first + randomAction(rng);
+            advance(nodes[node].action);
+        }
+
+        //Leaf Evaluation : random inputs to a fixed frame depth
+        for (uint32_t f = 0; f < config.rolloutFrames; ++f) {
+            if (f % config.framesPerAction == 0) {
+                applyAction(env, randomAction(rng) - 1);
+            }
+            env.runFrame(config.instructionsPerFrame);
+        }
+        double value = score(env, rootValues);
+
+        //Backpropagation
+        for (int32_t n = node; n >= 0; n = nodes[n].parent) {
+            ++nodes[n].visits;
+            nodes[n].valueSum += value;
+        }
+    }
+
+    if (nodes[0].firstChild >= 0) {
+        for (int a = 0; a < NUM_ACTIONS; ++a) {
+            rootVisits[a] = nodes[nodes[0].firstChild + a].visits;
+        }
+    }
+}
+
+int TreeSearch::search(const Chip8 &root) const {
+    std::vector<std::vector<uint64_t>> visits(config.numThreads, std::vector<uint64_t>(NUM_ACTIONS, 0));
+    std::vector<std::thread> threads;
+
+    for (size_t t = 1; t < config.numThreads; ++t) {
+        threads.emplace_back(&TreeSearch::searchThread, this, std::cref(root),
+                             config.seed + static_cast<uint32_t>(t), std::ref(visits[t]));
+    }
+    searchThread(root, config.seed, visits[0]);
+
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    int best = 0;
+    uint64_t bestVisits = 0;
+    for (int a = 0; a < NUM_ACTIONS; ++a) {
+        uint64_t total = 0;
+        for (const auto &v : visits) {
+            total += v[a];
+        }
+        if (total > bestVisits) {
+            bestVisits = total;
+            best = a;
+        }
+    }
+    return best - 1;
+}
@@ -0,0 +1,50 @@
+#ifndef TREE_SEARCH_H
+#define TREE_SEARCH_H
+
+#include <vector>
+#include <random>
+
+#include "chip8.h"
+#include "vec_env.h"
+
+constexpr int NUM_ACTIONS = 17;     // NO_ACTION + 16 keys
+
+struct TreeSearchConfig {
+    size_t numThreads = 0;              // 0 = hardware_concurrency
+    uint32_t iterations = 2000;         // Per thread
+    uint32_t instructionsPerFrame = 10;
+    uint32_t framesPerAction = 4;       // Frames a key is held per tree edge
+    uint32_t rolloutFrames = 120;       // Depth of the headless leaf evaluation
+    double exploration = 1.41;
+    uint32_t seed = 1;
+    std::vector<RewardAddress> rewardAddresses;
+};
+
+/**
+ * Monte Carlo tree search over keypad inputs
+ * Root-parallel : every thread grows its own tree from the same root state,
+ * visit counts of the root children are summed to pick the action
+ */
+class TreeSearch {
+   private:
+    struct Node {
+        int32_t parent;
+        int32_t firstChild;     // -1 until expanded, children are contiguous
+        int32_t action;
+        uint32_t visits;
+        double valueSum;
+    };
+
+    TreeSearchConfig config;
+
+    double score(const Chip8 &env, const std::vector<uint8_t> &rootValues) const;
+    void searchThread(const Chip8 &rootEnv, uint32_t seed, std::vector<uint64_t> &rootVisits) const;
+
+   public:
+    explicit TreeSearch(const TreeSearchConfig &cfg);
+
+    // Returns NO_ACTION or the keypad index to hold next
+    int search(const Chip8 &root) const;
+};
+
+#endif // TREE_SEARCH_H
@@ -0,0 +1,167 @@
+#include "upscaler.h"
+
+#include <cstring>
+#include <algorithm>
+
+// Neighbourhood bit for row r, column c of the 3x3 window; bit 8 = top-left, bit 4 = centre
+static constexpr uint32_t cell(uint32_t neighbourhood, int r, int c) {
+    return (neighbourhood >> (8 - (r * 3 + c))) & 1U;
+}
+
+/**
+ * Scale2x rule, generalised to NxN : a corner takes the colour of the two
+ * neighbours meeting there when they agree, differ from the centre, and
+ * the opposite neighbours match the centre. "Corner" is every subpixel
+ * on or past the cell's diagonal, so 2x cuts one subpixel, 3x one and
+ * 4x a triangle of three.
+ */
+static constexpr uint16_t makePattern(uint32_t n, uint32_t neighbourhood) {
+    const uint32_t centre = cell(neighbourhood, 1, 1);
+    const int dirs[2] = {-1, 1};
+    uint16_t out = 0;
+
+    for (uint32_t j = 0; j < n; ++j) {
+        for (uint32_t i = 0; i < n; ++i) {
+            //Subpixel centre relative to the cell centre, in units of 1 / 2n
+            int u = static_cast<int>(2 * i + 1) - static_cast<int>(n);
+            int v = static_cast<int>(2 * j + 1) - static_cast<int>(n);
+            uint32_t lit = centre;
+
+            for (int dx : dirs) {
+                for (int dy : dirs) {
+                    if (u * dx + v * dy < static_cast<int>(n)) {
+                        continue;
+                    }
+
+                    uint32_t side = cell(neighbourhood, 1, 1 + dx);
+                    uint32_t vertical = cell(neighbourhood, 1 + dy, 1);
+                    uint32_t oppositeSide = cell(neighbourhood, 1, 1 - dx);
+                    uint32_t oppositeVertical = cell(neighbourhood, 1 - dy, 1);
+
+                    if (side == vertical && side != centre && oppositeSide == centre && oppositeVertical == centre) {
+                        lit = side;
+                    }
+                }
+            }
+            out |= static_cast<uint16_t>(lit << (n * n - 1 - (j * n + i)));
+        }
+    }
+    return out;
+}
+
+template <uint32_t N>
+static constexpr std::array<uint16_t, 512> makeTable() {
+    std::array<uint16_t, 512> table{};
+    for (uint32_t nb = 0; nb < 512; ++nb) {
+        table[nb] = makePattern(N, nb);
+    }
+    return table;
+}
+
+static constexpr std::array<uint16_t, 512> TABLE_2X = makeTable<2>();
+static constexpr std::array<uint16_t, 512> TABLE_3X = makeTable<3>();
+static constexpr std::array<uint16_t, 512> TABLE_4X = makeTable<4>();
+
+static_assert(TABLE_2X[0x010] == 0xF, "An isolated pixel stays a square");
+static_assert(TABLE_2X[0xA0] == 0x8, "Up and left lit round off the top-left corner");
+static_assert(TABLE_4X[0xA0] == 0xC800, "4x cuts a three subpixel triangle");
+
+Upscaler::Upscaler(uint32_t factor) : n(std::clamp<uint32_t>(factor, 1, MAX_UPSCALE)) {
+    switch (n) {
+        case 2:
+            table = &TABLE_2X;
+            break;
+        case 3:
+            table = &TABLE_3X;
+            break;
+        case 4:
+            table = &TABLE_4X;
+            break;
+        default:
+            table = nullptr;
+            break;
+    }
+    pixels.assign(rowBytes() * outputHeight(), 0);
+}
+
+uint16_t Upscaler::pattern(uint32_t factor, uint32_t neighbourhood) {
+    switch (factor) {
+        case 2:
+            return TABLE_2X[neighbourhood & 0x1FF];
+        case 3:
+            return TABLE_3X[neighbourhood & 0x1FF];
+        case 4:
+            return TABLE_4X[neighbourhood & 0x1FF];
+        default:
+            return cell(neighbourhood, 1, 1);
+    }
+}
+
+void Upscaler::apply(const uint8_t (&display)[VIDEO_HEIGHT][VIDEO_ROW_BYTES], uint32_t dirtyRows) {
+    uint32_t rows = affectedRows(dirtyRows);
+
+    if (!table) {
+        for (uint32_t r = 0; r < VIDEO_HEIGHT; ++r) {
+            if (rows & (1U << r)) {
+                std::memcpy(&pixels[r * VIDEO_ROW_BYTES], display[r], VIDEO_ROW_BYTES);
+            }
+        }
+        return;
+    }
+
+    //Off-screen neighbours count as unlit
+    auto rowBits = [&](int r) -> uint64_t {
+        uint64_t bits = 0;
+        if (r >= 0 && r < static_cast<int>(VIDEO_HEIGHT)) {
+            for (uint32_t b = 0; b < VIDEO_ROW_BYTES; ++b) {
+                bits = (bits << 8) | display[r][b];
+            }
+        }
+        return bits;
+    };
+
+    const uint32_t mask = (1U << n) - 1;
+
+    for (uint32_t r = 0; r < VIDEO_HEIGHT; ++r) {
+        if (!(rows & (1U << r))) {
+            continue;
+        }
+
+        uint64_t up = rowBits(static_cast<int>(r) - 1);
+        uint64_t mid = rowBits(static_cast<int>(r));
+        uint64_t down = rowBits(static_cast<int>(r) + 1);
+
+        uint8_t *out = &pixels[r * n * rowBytes()];
+        std::memset(out, 0, n * rowBytes());
+        if (!(up | mid | down)) {
+            continue;
+        }
+
+        for (uint32_t x = 0; x < VIDEO_WIDTH; ++x) {
+            uint32_t shift = VIDEO_WIDTH - 1 - x;
+            auto triple = [&](uint64_t w) -> uint32_t {
+                uint32_t left = x > 0 ? (w >> (shift + 1)) & 1U : 0;
+                uint32_t right = x < VIDEO_WIDTH - 1 ? (w >> (shift - 1)) & 1U : 0;
+                return (left << 2) | (((w >> shift) & 1U) << 1) | right;
+            };
+
+            uint16_t block = (*table)[(triple(up) << 6) | (triple(mid) << 3) | triple(down)];
+            if (!block) {
+                continue;
+            }
+
+            //Place each N-bit block row at bit x * N of its output row
+            uint32_t offset = x * n;
+            for (uint32_t j = 0; j < n; ++j) {
+                uint32_t bits = (block >> ((n - 1 - j) * n)) & mask;
+                uint32_t window = bits << (16 - offset % 8 - n);
+                uint8_t *dst = out + j * rowBytes() + offset / 8;
+
+                dst[0] |= static_cast<uint8_t>(window >> 8);
+                if (window & 0xFFU) {
+                    dst[1] |= static_cast<uint8_t>(window);
+                }
+            }
+        }
+    }
+}
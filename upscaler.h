@@ -0,0 +1,55 @@
+#ifndef UPSCALER_H
+#define UPSCALER_H
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+#include "chip8.h"
+
+constexpr uint32_t MAX_UPSCALE = 4;
+
+/**
+ * Pixel-art upscaler for the 1 bpp display (Scale2x/EPX rule, 2x-4x)
+ * Each of the 512 possible 3x3 neighbourhoods maps to a precomputed NxN
+ * block, so a source pixel costs one table lookup. The output is packed
+ * 1 bpp like the display, (64 * N) x (32 * N), MSB = leftmost.
+ */
+class Upscaler {
+   private:
+    uint32_t n;
+    const std::array<uint16_t, 512> *table;
+    std::vector<uint8_t> pixels;
+
+   public:
+    explicit Upscaler(uint32_t factor);
+
+    uint32_t factor() const noexcept {
+        return n;
+    }
+
+    uint32_t rowBytes() const noexcept {
+        return VIDEO_ROW_BYTES * n;
+    }
+
+    uint32_t outputHeight() const noexcept {
+        return VIDEO_HEIGHT * n;
+    }
+
+    const uint8_t *row(uint32_t y) const noexcept {
+        return &pixels[y * rowBytes()];
+    }
+
+    // Display rows whose output changes when dirtyRows change (neighbours included)
+    static uint32_t affectedRows(uint32_t dirtyRows) noexcept {
+        return dirtyRows | (dirtyRows << 1) | (dirtyRows >> 1);
+    }
+
+    // Re-expand affectedRows(dirtyRows); factor 1 copies the display
+    void apply(const uint8_t (&display)[VIDEO_HEIGHT][VIDEO_ROW_BYTES], uint32_t dirtyRows);
+
+    // NxN block for a neighbourhood, row-major from the top, MSB = leftmost
+    static uint16_t pattern(uint32_t factor, uint32_t neighbourhood);
+};
+
+#endif // UPSCALER_H
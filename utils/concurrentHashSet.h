@@ -0,0 +1,64 @@
+#ifndef UTILS_CONCURRENTHASHSET
+#define UTILS_CONCURRENTHASHSET
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Lock-free insert-only set of 64-bit hashes
+ * Open addressing with linear probing, 0 marks an empty slot
+ */
+class ConcurrentHashSet {
+   private:
+    std::unique_ptr<std::atomic<uint64_t>[]> slots;
+    size_t mask;
+    std::atomic<size_t> count{0};
+
+   public:
+    explicit ConcurrentHashSet(size_t expected) {
+        size_t capacity = 16;
+        while (capacity < expected * 2) {
+            capacity <<= 1;
+        }
+        mask = capacity - 1;
+        slots = std::make_unique<std::atomic<uint64_t>[]>(capacity);
+        for (size_t i = 0; i < capacity; ++i) {
+            slots[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Returns true if the key was not present
+    bool insert(uint64_t key) noexcept {
+        key = key ? key : 1;
+
+        for (size_t i = key & mask, probes = 0; probes <= mask; i = (i + 1) & mask, ++probes) {
+            uint64_t current = slots[i].load(std::memory_order_relaxed);
+
+            if (current == key) {
+                return false;
+            }
+            if (current == 0) {
+                if (slots[i].compare_exchange_strong(current, key, std::memory_order_relaxed)) {
+                    count.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+                if (current == key) {
+                    return false;
+                }
+            }
+        }
+        return false;   //Full
+    }
+
+    size_t size() const noexcept {
+        return count.load(std::memory_order_relaxed);
+    }
+
+    size_t capacity() const noexcept {
+        return mask + 1;
+    }
+};
+
+#endif // UTILS_CONCURRENTHASHSET
@@ -1,5 +1,51 @@
 #include "configReader.h"
 
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+
+static const char *backgroundModeName(BackgroundMode mode) {
+    switch (mode) {
+        case BackgroundMode::LOW_POWER:
+            return "low_power";
+        case BackgroundMode::PAUSE:
+            return "pause";
+        default:
+            return "run";
+    }
+}
+
+static BackgroundMode parseBackgroundMode(const char *name, BackgroundMode fallback) {
+    for (auto mode : {BackgroundMode::RUN, BackgroundMode::LOW_POWER, BackgroundMode::PAUSE}) {
+        if (std::strcmp(name, backgroundModeName(mode)) == 0) {
+            return mode;
+        }
+    }
+    return fallback;
+}
+
+static const char *THEME_KEYS[4] = {"background", "foreground", "colour2", "colour3"};
+
+static std::string colourName(uint32_t rgb) {
+    char name[8];
+    std::snprintf(name, sizeof(name), "#%06X", rgb & 0xFFFFFFU);
+    return name;
+}
+
+// "#RRGGBB" or "RRGGBB"
+static uint32_t parseColour(const char *name, uint32_t fallback) {
+    if (*name == '#') {
+        ++name;
+    }
+    char *end = nullptr;
+    unsigned long rgb = std::strtoul(name, &end, 16);
+    if (end - name != 6 || *end != '\0') {
+        return fallback;
+    }
+    return static_cast<uint32_t>(rgb);
+}
+
 bool configReader::createDefaultConfigFile(const char *file) {
     CSimpleIniA defaultConfig(true, false, false);
 
@@ -9,6 +55,23 @@ bool configReader::createDefaultConfigFile(const char *file) {
         defaultConfig.SetValue("Recent", romNum.c_str(), "");
     }
 
+    EmuSettings defaults;
+    defaultConfig.SetDoubleValue("Emulation", "cpu_hz", defaults.cpuHz, "; Instructions per second, 0 = unlimited");
+    defaultConfig.SetBoolValue("Emulation", "vsync", defaults.vsync, "; Lock emulation to the display refresh");
+    defaultConfig.SetLongValue("Emulation", "frame_skip", defaults.frameSkip, "; Frames left undrawn in a row while the host is behind, 0 = never");
+    defaultConfig.SetLongValue("Emulation", "run_ahead", defaults.runAhead, "; Frames shown ahead of the machine to hide input lag, 0 = off");
+    defaultConfig.SetLongValue("Emulation", "spin_us", defaults.spinUs, "; Microseconds spun before each frame deadline, 0 = sleep only");
+    defaultConfig.SetValue("Emulation", "minimized", backgroundModeName(defaults.minimized), "; While minimised : run, low_power (timers only) or pause");
+    defaultConfig.SetValue("Emulation", "unfocused", backgroundModeName(defaults.unfocused), "; While unfocused : run, low_power (timers only) or pause");
+
+    defaultConfig.SetLongValue("Realtime", "priority", defaults.rtPriority, "; SCHED_FIFO priority 1-99 for the emulation thread, 0 = normal");
+    defaultConfig.SetLongValue("Realtime", "cpu", defaults.cpuAffinity, "; Pin the emulation thread to this CPU, -1 = any");
+    defaultConfig.SetLongValue("Render", "upscale", defaults.upscale, "; Smooth pixel-art upscale on the CPU : 1 (off), 2, 3 or 4");
+    for (int i = 0; i < 4; ++i) {
+        defaultConfig.SetValue("Theme", THEME_KEYS[i], colourName(defaults.theme[i]).c_str(),
+                               i == 0 ? "; Colours as #RRGGBB, colour2 / colour3 are XO-CHIP's extra plane colours" : nullptr);
+    }
+
     if (defaultConfig.SaveFile(file) >= 0) {
         std::cerr << "Created " << configFile << std::endl;
         return true;
@@ -38,6 +101,22 @@ configReader::configReader(std::string filepath) : ini(true, false, false) {
         std::cerr << romNum << " : " << a << std::endl;
         recentROM[i] = a;
     }
+
+    //Emulation Settings
+    settings.cpuHz = std::max(0.0, ini.GetDoubleValue("Emulation", "cpu_hz", settings.cpuHz));
+    settings.vsync = ini.GetBoolValue("Emulation", "vsync", settings.vsync);
+    settings.frameSkip = static_cast<int>(std::max(0L, ini.GetLongValue("Emulation", "frame_skip", settings.frameSkip)));
+    settings.runAhead = static_cast<int>(std::clamp(ini.GetLongValue("Emulation", "run_ahead", settings.runAhead), 0L, 4L));
+    settings.spinUs = static_cast<int>(std::max(0L, ini.GetLongValue("Emulation", "spin_us", settings.spinUs)));
+    settings.minimized = parseBackgroundMode(ini.GetValue("Emulation", "minimized", ""), settings.minimized);
+    settings.unfocused = parseBackgroundMode(ini.GetValue("Emulation", "unfocused", ""), settings.unfocused);
+    settings.rtPriority = static_cast<int>(std::clamp(ini.GetLongValue("Realtime", "priority", settings.rtPriority), 0L, 99L));
+    settings.cpuAffinity = static_cast<int>(std::max(-1L, ini.GetLongValue("Realtime", "cpu", settings.cpuAffinity)));
+    settings.upscale = static_cast<int>(std::clamp(ini.GetLongValue("Render", "upscale", settings.upscale), 1L, 4L));
+    for (int i = 0; i < 4; ++i) {
+        settings.theme[i] = parseColour(ini.GetValue("Theme", THEME_KEYS[i], ""), settings.theme[i]);
+    }
+    std::cerr << "CPU : " << settings.cpuHz << " Hz" << (settings.vsync ? " | VSync" : "") << std::endl;
 }
 
 std::string configReader::getRecentROM(int idx) {
@@ -7,11 +7,13 @@
 #include <string>
 #include <array>
 #include "simpleIni.h"
+#include "emuSettings.h"
 
 class configReader {
    private:
     std::string configFile = "chip8emu.ini";
     std::array<std::string, 10> recentROM;
+    EmuSettings settings;
     CSimpleIniA ini;
 
     bool createDefaultConfigFile(const char *file);
@@ -21,6 +23,10 @@ class configReader {
 
     std::string getRecentROM(int idx);
 
+    const EmuSettings &getSettings() const noexcept {
+        return settings;
+    }
+
     constexpr size_t getRecentROMSize() const noexcept {
         return recentROM.size();
     }
@@ -0,0 +1,34 @@
+#ifndef UTILS_EMUSETTINGS
+#define UTILS_EMUSETTINGS
+
+#include <cstdint>
+
+// What the emulator does while its window is minimised or unfocused
+enum class BackgroundMode {
+    RUN,            // Keep emulating and drawing
+    LOW_POWER,      // Tick timers and audio only, no instructions or draws
+    PAUSE,          // Stop until the window comes back
+};
+
+// Runtime options read from chip8emu.ini [Emulation]
+struct EmuSettings {
+    double cpuHz = 700.0;       // Instructions per second, 0 = unlimited
+    bool vsync = false;         // Drive emulation from the display refresh
+    int frameSkip = 4;          // Consecutive presents dropped while behind, 0 = never
+    int runAhead = 0;           // Frames presented ahead of the real machine, 0 = off
+    int spinUs = 200;           // Busy-wait tail before each frame deadline, 0 = sleep only
+    BackgroundMode minimized = BackgroundMode::PAUSE;
+    BackgroundMode unfocused = BackgroundMode::RUN;
+
+    // [Realtime] : applied to the thread that runs the emulation
+    int rtPriority = 0;         // SCHED_FIFO priority 1-99, 0 = normal scheduling
+    int cpuAffinity = -1;       // Logical CPU to pin to, -1 = any
+
+    // [Render]
+    int upscale = 1;            // Pixel-art upscale before upload : 1 (off), 2, 3 or 4
+
+    // [Theme] : 0xRRGGBB, indexed by pixel value (XO-CHIP planes use all four)
+    uint32_t theme[4] = {0x000000, 0xFFFFFF, 0xAAAAAA, 0x555555};
+};
+
+#endif // UTILS_EMUSETTINGS
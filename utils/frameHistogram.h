@@ -0,0 +1,109 @@
+#ifndef UTILS_FRAMEHISTOGRAM
+#define UTILS_FRAMEHISTOGRAM
+
+#include <array>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * Histogram of frame intervals in milliseconds
+ * 200 buckets (0.25 ms wide by default), longer intervals land in the last bucket
+ */
+class FrameHistogram {
+   private:
+    static constexpr size_t BUCKETS = 200;
+
+    double bucketMs;
+    std::array<uint32_t, BUCKETS + 1> counts{};
+    uint64_t total = 0;
+    double sum = 0.0;
+    double max = 0.0;
+
+   public:
+    explicit FrameHistogram(double bucketMs = 0.25) : bucketMs(bucketMs) {}
+
+    void record(double ms) {
+        size_t bucket = std::min(static_cast<size_t>(std::max(ms, 0.0) / bucketMs), BUCKETS);
+        ++counts[bucket];
+        ++total;
+        sum += ms;
+        max = std::max(max, ms);
+    }
+
+    // Upper edge of the bucket holding the p-th fraction of samples
+    double percentile(double p) const {
+        uint64_t target = static_cast<uint64_t>(p * total);
+        uint64_t seen = 0;
+
+        for (size_t i = 0; i <= BUCKETS; ++i) {
+            seen += counts[i];
+            if (seen > target) {
+                return (i + 1) * bucketMs;
+            }
+        }
+        return max;
+    }
+
+    double mean() const {
+        return total ? sum / total : 0.0;
+    }
+
+    uint64_t samples() const noexcept {
+        return total;
+    }
+
+    std::string summary(const char *name) const {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(2) << name << " : n=" << total
+           << " mean " << mean() << " p50 " << percentile(0.50) << " p99 " << percentile(0.99)
+           << " max " << max << " ms";
+        return ss.str();
+    }
+
+    // One text bar per group of buckets, from the first sample up to the p99.9 bucket
+    std::string bars(const char *name, size_t rows = 8, size_t width = 40) const {
+        std::stringstream ss;
+        ss << name << " :\n";
+        if (total == 0) {
+            return ss.str();
+        }
+
+        size_t first = 0;
+        while (counts[first] == 0) {
+            ++first;
+        }
+        size_t last = std::clamp(static_cast<size_t>(percentile(0.999) / bucketMs), first + 1, BUCKETS + 1);
+        size_t span = std::max<size_t>(1, (last - first + rows - 1) / rows);
+
+        std::vector<uint64_t> grouped;
+        for (size_t i = first; i < last; i += span) {
+            uint64_t n = 0;
+            for (size_t j = i; j < std::min(i + span, BUCKETS + 1); ++j) {
+                n += counts[j];
+            }
+            grouped.push_back(n);
+        }
+        uint64_t peak = *std::max_element(grouped.begin(), grouped.end());
+
+        ss << std::fixed << std::setprecision(2);
+        for (size_t r = 0; r < grouped.size(); ++r) {
+            double low = (first + r * span) * bucketMs;
+            ss << std::setw(7) << low << "-" << std::setw(7) << low + span * bucketMs << " ms |"
+               << std::string(peak ? grouped[r] * width / peak : 0, '#') << " " << grouped[r] << "\n";
+        }
+        return ss.str();
+    }
+
+    void clear() {
+        counts.fill(0);
+        total = 0;
+        sum = 0.0;
+        max = 0.0;
+    }
+};
+
+#endif // UTILS_FRAMEHISTOGRAM
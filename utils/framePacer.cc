@@ -0,0 +1,94 @@
+#include "framePacer.h"
+
+#include <thread>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <timeapi.h>
+#else
+#include <ctime>
+#include <cerrno>
+#endif
+
+FramePacer::FramePacer(std::chrono::microseconds spin, std::chrono::microseconds missThreshold)
+    : spin(spin), missThreshold(missThreshold) {
+#if defined(_WIN32)
+    timeBeginPeriod(1);     //1 ms scheduler granularity instead of ~15.6 ms
+#endif
+}
+
+FramePacer::~FramePacer() {
+#if defined(_WIN32)
+    timeEndPeriod(1);
+#endif
+}
+
+void FramePacer::sleepUntil(clock::time_point deadline) {
+#if defined(__linux__)
+    //steady_clock is CLOCK_MONOTONIC on Linux
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(ns / 1000000000LL);
+    ts.tv_nsec = static_cast<long>(ns % 1000000000LL);
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+    }
+#else
+    std::this_thread::sleep_until(deadline);
+#endif
+}
+
+void FramePacer::waitUntil(clock::time_point deadline) {
+    waits.fetch_add(1, std::memory_order_relaxed);
+
+    if (clock::now() >= deadline) {
+        misses.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    sleepUntil(deadline - spin);
+
+    while (clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+
+    double lateUs = std::chrono::duration<double, std::micro>(clock::now() - deadline).count();
+    maxLateUs = std::max(maxLateUs, lateUs);
+    if (lateUs > missThreshold.count()) {
+        misses.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+std::string FramePacer::summary() const {
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1) << "Pacing : " << waitCount() << " deadlines, "
+       << missCount() << " missed, max late " << maxLateUs << " us";
+    return ss.str();
+}
+
+void FramePacer::resetStats() {
+    waits.store(0, std::memory_order_relaxed);
+    misses.store(0, std::memory_order_relaxed);
+    maxLateUs = 0.0;
+}
+
+double FramePacer::processCpuSeconds() {
+#if defined(_WIN32)
+    FILETIME creation, exit, kernel, user;
+    GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+
+    auto toSeconds = [](const FILETIME &ft) {
+        return ((static_cast<uint64_t>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime) * 1e-7;
+    };
+    return toSeconds(kernel) + toSeconds(user);
+#else
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
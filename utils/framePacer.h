@@ -0,0 +1,50 @@
+#ifndef UTILS_FRAMEPACER
+#define UTILS_FRAMEPACER
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <cstdint>
+
+/**
+ * Sleeps until absolute deadlines without polling
+ * Sleeps to (deadline - spin) and then spins the rest for precision;
+ * spin = 0 disables spinning
+ */
+class FramePacer {
+   public:
+    using clock = std::chrono::steady_clock;
+
+    explicit FramePacer(std::chrono::microseconds spin = std::chrono::microseconds(0),
+                        std::chrono::microseconds missThreshold = std::chrono::microseconds(1000));
+    ~FramePacer();
+
+    void waitUntil(clock::time_point deadline);
+
+    // Deadlines already passed when waitUntil() was called, or woken past missThreshold
+    uint64_t missCount() const noexcept {
+        return misses.load(std::memory_order_relaxed);
+    }
+
+    uint64_t waitCount() const noexcept {
+        return waits.load(std::memory_order_relaxed);
+    }
+
+    std::string summary() const;
+    void resetStats();
+
+    // CPU time of the whole process, all threads
+    static double processCpuSeconds();
+
+   private:
+    std::chrono::microseconds spin;
+    std::chrono::microseconds missThreshold;
+
+    std::atomic<uint64_t> waits{0};
+    std::atomic<uint64_t> misses{0};
+    double maxLateUs = 0.0;
+
+    void sleepUntil(clock::time_point deadline);
+};
+
+#endif // UTILS_FRAMEPACER
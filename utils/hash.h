@@ -0,0 +1,34 @@
+#ifndef UTILS_HASH
+#define UTILS_HASH
+
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+// 64-bit finaliser (splitmix64)
+constexpr uint64_t mix64(uint64_t x) noexcept {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// Hash a byte range 8 bytes at a time
+inline uint64_t hashBytes(const void *data, size_t size, uint64_t seed = 0) noexcept {
+    const auto *p = static_cast<const uint8_t *>(data);
+    uint64_t h = seed ^ (size * 0x9E3779B97F4A7C15ULL);
+
+    for (; size >= 8; size -= 8, p += 8) {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        h = mix64(h ^ word) + 0x9E3779B97F4A7C15ULL;
+    }
+
+    uint64_t tail = 0;
+    std::memcpy(&tail, p, size);
+    return mix64(h ^ tail);
+}
+
+#endif // UTILS_HASH
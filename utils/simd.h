@@ -0,0 +1,42 @@
+#ifndef UTILS_SIMD
+#define UTILS_SIMD
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CHIP8_SIMD_X86
+#endif
+
+enum class SimdLevel {
+    SCALAR,
+    SSE2,
+    AVX2,
+};
+
+// Best kernel the running CPU supports, probed once
+inline SimdLevel detectSimd() {
+    static const SimdLevel level = []() {
+#ifdef CHIP8_SIMD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return SimdLevel::AVX2;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            return SimdLevel::SSE2;
+        }
+#endif
+        return SimdLevel::SCALAR;
+    }();
+    return level;
+}
+
+inline const char *simdName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2:
+            return "AVX2";
+        case SimdLevel::SSE2:
+            return "SSE2";
+        default:
+            return "Scalar";
+    }
+}
+
+#endif // UTILS_SIMD
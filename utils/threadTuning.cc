@@ -0,0 +1,50 @@
+#include "threadTuning.h"
+
+#include <iostream>
+#include <thread>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+bool setRealtimePriority(int priority) {
+#if defined(_WIN32)
+    (void)priority;
+    return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL) != 0;
+#else
+    sched_param param{};
+    param.sched_priority = priority;
+    return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+#endif
+}
+
+bool pinToCpu(int cpu) {
+    //CPU_SET past the mask and shifts past 63 are undefined, so bad config values stop here
+    unsigned cpus = std::thread::hardware_concurrency();
+    if (cpu < 0 || (cpus > 0 && static_cast<unsigned>(cpu) >= cpus)) {
+        std::cerr << "WARNING : CPU " << cpu << " out of range (" << cpus << " logical CPUs), thread not pinned" << std::endl;
+        return false;
+    }
+
+#if defined(_WIN32)
+    return cpu < 64 && SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+#elif defined(__linux__)
+    if (cpu >= CPU_SETSIZE) {
+        std::cerr << "WARNING : CPU " << cpu << " past CPU_SETSIZE (" << CPU_SETSIZE << "), thread not pinned" << std::endl;
+        return false;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
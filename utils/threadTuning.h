@@ -0,0 +1,16 @@
+#ifndef UTILS_THREADTUNING
+#define UTILS_THREADTUNING
+
+/**
+ * Scheduling tweaks applied to the calling thread
+ * Both return false (and leave the thread as it was) when the OS refuses,
+ * usually for lack of CAP_SYS_NICE / an rtprio limit
+ */
+
+// SCHED_FIFO at the given priority (1-99); TIME_CRITICAL on Windows
+bool setRealtimePriority(int priority);
+
+// Restrict the calling thread to one logical CPU, out-of-range CPUs are refused with a warning
+bool pinToCpu(int cpu);
+
+#endif // UTILS_THREADTUNING
@@ -0,0 +1,51 @@
+#ifndef UTILS_TRIPLEBUFFER
+#define UTILS_TRIPLEBUFFER
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Single-producer / single-consumer triple buffer
+ * The writer fills its back buffer and publishes it into the middle slot,
+ * the reader swaps the middle slot for its front buffer when it is fresh.
+ * Neither side ever waits for the other.
+ */
+template <typename T>
+class TripleBuffer {
+   private:
+    static constexpr uint8_t FRESH = 0x4;     //Middle slot holds an unread frame
+
+    T buffers[3]{};
+    std::atomic<uint8_t> middle{1};
+    uint8_t back = 0;
+    uint8_t front = 2;
+
+   public:
+    // Writer side
+    T &writeBuffer() noexcept {
+        return buffers[back];
+    }
+
+    // Returns true if an unread frame was overwritten (the reader skipped it)
+    bool publish() noexcept {
+        uint8_t previous = middle.exchange(back | FRESH, std::memory_order_acq_rel);
+        back = previous & 0x3;
+        return (previous & FRESH) != 0;
+    }
+
+    // Reader side, returns true if a newer frame was picked up
+    bool acquire() noexcept {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) {
+            return false;
+        }
+        uint8_t previous = middle.exchange(front, std::memory_order_acq_rel);
+        front = previous & 0x3;
+        return true;
+    }
+
+    const T &readBuffer() const noexcept {
+        return buffers[front];
+    }
+};
+
+#endif // UTILS_TRIPLEBUFFER
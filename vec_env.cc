@@ -0,0 +1,146 @@
+#include "vec_env.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+VecEnv::VecEnv(const VecEnvConfig &cfg) : config(cfg), pool(cfg.numEnvs) {
+    if (config.numThreads == 0) {
+        config.numThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    config.numThreads = std::clamp<size_t>(config.numThreads, 1, std::max<size_t>(config.numEnvs, 1));
+
+    //One ROM image shared by every env, fonts alone would step without error and score nothing
+    auto image = Chip8::loadImage(config.romPath.c_str());
+    if (!image) {
+        throw std::runtime_error("VecEnv : failed to load ROM " + config.romPath);
+    }
+
+    envs.reserve(config.numEnvs);
+    for (size_t i = 0; i < config.numEnvs; ++i) {
+        Chip8 *env = pool.borrow();
+        if (!env) {
+            throw std::runtime_error("VecEnv : machine pool exhausted");
+        }
+        env->useImage(image);
+        envs.push_back(env);
+    }
+
+    rewards.assign(config.numEnvs, 0.0f);
+    lastValues.assign(config.numEnvs * config.rewardAddresses.size(), 0);
+    for (size_t i = 0; i < config.numEnvs; ++i) {
+        sampleRewardAddresses(i);
+    }
+
+    //Calling thread runs chunk 0
+    for (size_t w = 1; w < config.numThreads; ++w) {
+        workers.emplace_back(&VecEnv::workerLoop, this, w);
+    }
+}
+
+VecEnv::~VecEnv() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    startCond.notify_all();
+
+    for (auto &t : workers) {
+        t.join();
+    }
+
+    for (auto *env : envs) {
+        pool.giveBack(env);
+    }
+}
+
+void VecEnv::workerLoop(size_t worker) {
+    uint64_t seen = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            startCond.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+        }
+
+        runChunk(worker);
+
+        std::lock_guard<std::mutex> lock(mtx);
+        if (--pending == 0) {
+            doneCond.notify_one();
+        }
+    }
+}
+
+// Envs are split into contiguous chunks, one per worker
+void VecEnv::runChunk(size_t worker) {
+    size_t chunk = (envs.size() + config.numThreads - 1) / config.numThreads;
+    size_t begin = worker * chunk;
+    size_t end = std::min(envs.size(), begin + chunk);
+
+    for (size_t i = begin; i < end; ++i) {
+        stepEnv(i);
+    }
+}
+
+void VecEnv::stepEnv(size_t idx) {
+    Chip8 &env = *envs[idx];
+    applyAction(env, actions[idx]);
+
+    for (uint32_t f = 0; f < config.frameSkip; ++f) {
+        env.runFrame(config.instructionsPerFrame);
+    }
+
+    float reward = 0.0f;
+    uint8_t *last = &lastValues[idx * config.rewardAddresses.size()];
+
+    for (size_t r = 0; r < config.rewardAddresses.size(); ++r) {
+        uint8_t value = env.peek(config.rewardAddresses[r].address);
+        reward += config.rewardAddresses[r].scale * (static_cast<int>(value) - last[r]);
+        last[r] = value;
+    }
+    rewards[idx] = reward;
+}
+
+void VecEnv::sampleRewardAddresses(size_t idx) {
+    uint8_t *last = &lastValues[idx * config.rewardAddresses.size()];
+
+    for (size_t r = 0; r < config.rewardAddresses.size(); ++r) {
+        last[r] = envs[idx]->peek(config.rewardAddresses[r].address);
+    }
+}
+
+/**
+ * Advance every env by frameSkip frames
+ * actionList must hold size() entries
+ */
+void VecEnv::step(const int *actionList) {
+    actions = actionList;
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        pending = workers.size();
+        ++generation;
+    }
+    startCond.notify_all();
+
+    runChunk(0);
+
+    std::unique_lock<std::mutex> lock(mtx);
+    doneCond.wait(lock, [&] { return pending == 0; });
+    actions = nullptr;
+}
+
+// Reset envs with a non-zero mask entry
+void VecEnv::reset(const uint8_t *mask) {
+    for (size_t i = 0; i < envs.size(); ++i) {
+        if (mask == nullptr || mask[i]) {
+            envs[i]->reset();
+            sampleRewardAddresses(i);
+            rewards[i] = 0.0f;
+        }
+    }
+}
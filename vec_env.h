@@ -0,0 +1,93 @@
+#ifndef VEC_ENV_H
+#define VEC_ENV_H
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "chip8.h"
+#include "machine_pool.h"
+
+constexpr int NO_ACTION = -1;
+
+// Hold a single key (or none) on the keypad
+inline void applyAction(Chip8 &env, int action) {
+    std::memset(env.keypad, 0, sizeof(env.keypad));
+    if (action >= 0 && action < 16) {
+        env.keypad[action] = 1;
+    }
+}
+
+// Memory byte whose change between steps is scored as reward
+struct RewardAddress {
+    uint16_t address;
+    float scale = 1.0f;
+};
+
+struct VecEnvConfig {
+    std::string romPath;
+    size_t numEnvs = 1;
+    size_t numThreads = 0;              // 0 = hardware_concurrency
+    uint32_t instructionsPerFrame = 10; // Instructions between 60 Hz timer ticks
+    uint32_t frameSkip = 4;             // Frames emulated per step
+    std::vector<RewardAddress> rewardAddresses;
+};
+
+// Packed 1-bit framebuffer, MSB of each byte is the leftmost pixel
+using Observation = uint8_t[VIDEO_HEIGHT][VIDEO_ROW_BYTES];
+
+/**
+ * Gym-style batch of headless Chip8 instances
+ * Actions are keypad indices [0x0-0xF] held for the whole step, or NO_ACTION
+ */
+class VecEnv {
+   private:
+    VecEnvConfig config;
+    MachinePool pool;
+    std::vector<Chip8 *> envs;
+    std::vector<float> rewards;
+    std::vector<uint8_t> lastValues;    // numEnvs * rewardAddresses.size()
+
+    //Worker Pool
+    std::vector<std::thread> workers;
+    std::mutex mtx;
+    std::condition_variable startCond;
+    std::condition_variable doneCond;
+    uint64_t generation = 0;
+    size_t pending = 0;
+    bool stopping = false;
+    const int *actions = nullptr;
+
+    void workerLoop(size_t worker);
+    void runChunk(size_t worker);
+    void stepEnv(size_t idx);
+    void sampleRewardAddresses(size_t idx);
+
+   public:
+    // Throws std::runtime_error if the ROM cannot be loaded
+    explicit VecEnv(const VecEnvConfig &cfg);
+    ~VecEnv();
+
+    VecEnv(const VecEnv &) = delete;
+    VecEnv &operator=(const VecEnv &) = delete;
+
+    void step(const int *actionList);
+    void reset(const uint8_t *mask);
+
+    size_t size() const noexcept {
+        return envs.size();
+    }
+
+    // Zero-copy view of the framebuffer, valid until the next step()/reset()
+    const Observation &observation(size_t idx) const {
+        return envs[idx]->display;
+    }
+
+    const float *reward() const noexcept {
+        return rewards.data();
+    }
+};
+
+#endif // VEC_ENV_H
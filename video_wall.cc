@@ -0,0 +1,112 @@
+#include "video_wall.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+#include "shader_utils.h"
+
+static const GLfloat CELL_VERTEX[3 * 6] = {
+    -1.0f, -1.0f, 0.0f,     // Rectangle, placed per instance by the vertex shader
+    -1.0f,  1.0f, 0.0f,
+     1.0f, -1.0f, 0.0f,
+     1.0f, -1.0f, 0.0f,
+    -1.0f,  1.0f, 0.0f,
+     1.0f,  1.0f, 0.0f,
+};
+
+// All state is bound once here, as App::setupObject() does; draw() only draws
+VideoWall::VideoWall(uint32_t screens, const GLfloat (&foreground)[4], const GLfloat (&background)[4])
+    : screens(std::clamp<uint32_t>(screens, 1, MAX_WALL_SCREENS)) {
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_CULL_FACE);
+
+    glGenVertexArrays(1, &vertexArrayID);
+    glBindVertexArray(vertexArrayID);
+
+    //Texture array, every layer blank until its first update()
+    glGenTextures(1, &textureID);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, textureID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_R8UI, VIDEO_ROW_BYTES, VIDEO_HEIGHT, this->screens,
+                 0, GL_RED_INTEGER, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, 0);
+
+    glGenBuffers(1, &vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(CELL_VERTEX), CELL_VERTEX, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, NULL);
+
+    shaderID = LoadShaders("wall_vertex.glsl", "wall_frag.glsl");
+    glUseProgram(shaderID);
+    glUniform1i(glGetUniformLocation(shaderID, "displaySampler"), 0);
+    glUniform4fv(glGetUniformLocation(shaderID, "foreground"), 1, foreground);
+    glUniform4fv(glGetUniformLocation(shaderID, "background"), 1, background);
+    gridLocation = glGetUniformLocation(shaderID, "grid");
+}
+
+VideoWall::~VideoWall() {
+    glUseProgram(0);
+    glDeleteBuffers(1, &vertexBuffer);
+    glDeleteVertexArrays(1, &vertexArrayID);
+    glDeleteProgram(shaderID);
+    glDeleteTextures(1, &textureID);
+}
+
+void VideoWall::resize(int width, int height) {
+    glViewport(0, 0, width, height);
+
+    //Cell aspect error in log space, so 1:1 and 4:1 are equally far from 2:1
+    double best = INFINITY;
+    for (uint32_t c = 1; c <= screens; ++c) {
+        uint32_t r = (screens + c - 1) / c;
+        double aspect = (static_cast<double>(width) / c) / (static_cast<double>(height) / r);
+        double error = std::abs(std::log(aspect / 2.0));
+        if (error < best) {
+            best = error;
+            gridColumns = c;
+            gridRows = r;
+        }
+    }
+    glUniform2i(gridLocation, static_cast<GLint>(gridColumns), static_cast<GLint>(gridRows));
+}
+
+void VideoWall::update(uint32_t screen, const uint8_t (&display)[VIDEO_HEIGHT][VIDEO_ROW_BYTES], uint32_t dirtyRows) {
+    if (!dirtyRows || screen >= screens) {
+        return;
+    }
+
+    int first = 0, last = VIDEO_HEIGHT - 1;
+    while (!(dirtyRows & (1U << first))) {
+        ++first;
+    }
+    while (!(dirtyRows & (1U << last))) {
+        --last;
+    }
+
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, first, screen, VIDEO_ROW_BYTES, last - first + 1, 1,
+                    GL_RED_INTEGER, GL_UNSIGNED_BYTE, display[first]);
+    ++uploadedLayers;
+    uploadedRows += last - first + 1;
+}
+
+void VideoWall::draw() {
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, static_cast<GLsizei>(screens));
+    ++draws;
+}
+
+void VideoWall::report(const char *name) {
+    double frames = static_cast<double>(std::max<uint64_t>(draws, 1));
+
+    std::cout << name << " : " << screens << " screens (" << gridColumns << "x" << gridRows << ") | "
+              << uploadedLayers / frames << " layers, " << uploadedRows / frames << " rows uploaded per frame"
+              << std::endl;
+
+    uploadedLayers = 0;
+    uploadedRows = 0;
+    draws = 0;
+}
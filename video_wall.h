@@ -0,0 +1,68 @@
+#ifndef VIDEO_WALL_H
+#define VIDEO_WALL_H
+
+#include <cstdint>
+
+#include <GL/glew.h>
+
+#include "chip8.h"
+
+constexpr uint32_t MAX_WALL_SCREENS = 64;
+
+/**
+ * Grid of displays drawn with one instanced draw call
+ * Every screen is a layer of one GL_R8UI texture array (packed 1 bpp, as
+ * the single window uses); instance n samples layer n into cell n of the
+ * grid (shaders/wall_*.glsl). update() uploads only the dirty rows of a
+ * layer, so screens that did not change cost nothing.
+ * Needs a current GL 3.3 context for its whole lifetime.
+ */
+class VideoWall {
+   private:
+    uint32_t screens;
+    uint32_t gridColumns = 1;
+    uint32_t gridRows = 1;
+
+    GLuint textureID = 0;
+    GLuint vertexArrayID = 0;
+    GLuint vertexBuffer = 0;
+    GLuint shaderID = 0;
+    GLint gridLocation = -1;
+
+    uint64_t uploadedLayers = 0;
+    uint64_t uploadedRows = 0;
+    uint64_t draws = 0;
+
+   public:
+    VideoWall(uint32_t screens, const GLfloat (&foreground)[4], const GLfloat (&background)[4]);
+    ~VideoWall();
+
+    VideoWall(const VideoWall &) = delete;
+    VideoWall &operator=(const VideoWall &) = delete;
+
+    // Pick the grid whose cells come closest to 2:1 in a width x height framebuffer
+    void resize(int width, int height);
+
+    // Upload the rows of screen set in dirtyRows (bit r = display row r), one call per screen at most
+    void update(uint32_t screen, const uint8_t (&display)[VIDEO_HEIGHT][VIDEO_ROW_BYTES], uint32_t dirtyRows);
+
+    // Every screen, one glDrawArraysInstanced
+    void draw();
+
+    uint32_t size() const noexcept {
+        return screens;
+    }
+
+    uint32_t columns() const noexcept {
+        return gridColumns;
+    }
+
+    uint32_t rows() const noexcept {
+        return gridRows;
+    }
+
+    // Layers / rows uploaded per draw since the last call, then reset
+    void report(const char *name);
+};
+
+#endif // VIDEO_WALL_H
@@ -0,0 +1,203 @@
+/**
+ * Video wall : many ROM instances in one window
+ * chip8wall [--screens N] [--hz N] rom [rom ...]
+ * ROMs are assigned round robin to N screens (default one per ROM, at most
+ * 64), each instance seeded differently so copies of one ROM diverge.
+ * Keys go to every instance; Enter resets all, Esc quits.
+ */
+
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+#include <array>
+#include <chrono>
+#include <algorithm>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "chip8.h"
+#include "machine_pool.h"
+#include "video_wall.h"
+#include "utils/framePacer.h"
+
+static const std::array<int, 16> KEY_MAPPING = {
+    'X', '1', '2', '3',
+    'Q', 'W', 'E', 'A',
+    'S', 'D', 'Z', 'C',
+    '4', 'R', 'F', 'V',
+};
+
+struct WallInput {
+    uint16_t keys = 0;
+    bool reset = false;
+    bool resized = true;
+};
+
+static void keyCallback(GLFWwindow *window, int key, int scancode, int action, int mods) {
+    auto *input = static_cast<WallInput *>(glfwGetWindowUserPointer(window));
+    auto idx = std::distance(KEY_MAPPING.begin(), std::find(KEY_MAPPING.begin(), KEY_MAPPING.end(), key));
+
+    if (idx < static_cast<long>(KEY_MAPPING.size())) {
+        if (action == GLFW_PRESS) {
+            input->keys |= static_cast<uint16_t>(1U << idx);
+        } else if (action == GLFW_RELEASE) {
+            input->keys &= static_cast<uint16_t>(~(1U << idx));
+        }
+    }
+    if (key == GLFW_KEY_ENTER && action == GLFW_PRESS) {
+        input->reset = true;
+    }
+    if (key == GLFW_KEY_ESCAPE) {
+        glfwSetWindowShouldClose(window, 1);
+    }
+}
+
+static void frameBufferResizeCallback(GLFWwindow *window, int width, int height) {
+    static_cast<WallInput *>(glfwGetWindowUserPointer(window))->resized = true;
+}
+
+int main(int argc, char *argv[]) {
+    std::vector<const char *> roms;
+    uint32_t screens = 0;
+    double cpuHz = 700.0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--screens") == 0 && i + 1 < argc) {
+            screens = static_cast<uint32_t>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--hz") == 0 && i + 1 < argc) {
+            cpuHz = std::max(60.0, std::atof(argv[++i]));
+        } else {
+            roms.push_back(argv[i]);
+        }
+    }
+    if (roms.empty()) {
+        std::cerr << "Usage : " << argv[0] << " [--screens N] [--hz N] rom [rom ...]" << std::endl;
+        return 1;
+    }
+    if (screens == 0) {
+        screens = static_cast<uint32_t>(roms.size());
+    }
+    screens = std::clamp<uint32_t>(screens, 1, MAX_WALL_SCREENS);
+
+    //Each distinct ROM is read once, every screen running it shares the image
+    std::vector<std::shared_ptr<const MemoryImage>> images(roms.size());
+    for (size_t r = 0; r < roms.size(); ++r) {
+        for (size_t prev = 0; prev < r && !images[r]; ++prev) {
+            if (std::strcmp(roms[prev], roms[r]) == 0) {
+                images[r] = images[prev];
+            }
+        }
+        if (!images[r]) {
+            images[r] = Chip8::loadImage(roms[r]);
+        }
+        if (!images[r]) {
+            std::cerr << "Failed to load ROM : " << roms[r] << std::endl;
+            return 1;
+        }
+    }
+
+    //Instances
+    MachinePool pool(screens);
+    std::vector<Chip8 *> machines;
+    for (uint32_t i = 0; i < screens; ++i) {
+        Chip8 *machine = pool.borrow();
+        machine->useImage(images[i % roms.size()]);
+        machine->seed(0x9E3779B9U * (i + 1));
+        machines.push_back(machine);
+    }
+
+    //Window, same context as the single-screen App
+    if (!glfwInit()) {
+        std::cerr << "Could not initialise GLFW (no display?)" << std::endl;
+        return 1;
+    }
+    glfwWindowHint(GLFW_SAMPLES, 0);
+    glfwWindowHint(GLFW_DEPTH_BITS, 0);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    GLFWwindow *window = glfwCreateWindow(1280, 720, "CHIP8-Emu Wall", NULL, NULL);
+    if (!window) {
+        std::cerr << "Could not create a GL 3.3 window" << std::endl;
+        glfwTerminate();
+        return 1;
+    }
+
+    WallInput input;
+    glfwMakeContextCurrent(window);
+    glfwSetWindowUserPointer(window, &input);
+    glewExperimental = true;
+    glewInit();
+    glfwSwapInterval(0);
+    glfwSetKeyCallback(window, keyCallback);
+    glfwSetFramebufferSizeCallback(window, frameBufferResizeCallback);
+
+    const GLfloat foreground[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    const GLfloat background[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    FramePacer pacer(std::chrono::microseconds(200));
+
+    {
+        VideoWall wall(screens, foreground, background);
+
+        const double perFrame = cpuHz / 60.0;
+        double owed = 0.0;
+        const auto period = std::chrono::duration_cast<FramePacer::clock::duration>(std::chrono::duration<double>(1.0 / 60.0));
+        auto deadline = FramePacer::clock::now();
+        auto lastReport = deadline;
+
+        while (!glfwWindowShouldClose(window)) {
+            glfwPollEvents();
+            if (input.resized) {
+                int width, height;
+                glfwGetFramebufferSize(window, &width, &height);
+                wall.resize(width, height);
+                input.resized = false;
+            }
+
+            owed += perFrame;
+            auto instructions = static_cast<uint32_t>(owed);
+            owed -= instructions;
+
+            //Emulate every screen, then upload only what each changed
+            for (uint32_t i = 0; i < screens; ++i) {
+                Chip8 *machine = machines[i];
+                if (input.reset) {
+                    machine->reset();
+                }
+                for (int k = 0; k < 16; ++k) {
+                    machine->keypad[k] = (input.keys >> k) & 1U;
+                }
+                machine->runFrame(instructions);
+
+                wall.update(i, machine->display, machine->dirtyRows);
+                machine->dirtyRows = 0;
+            }
+            input.reset = false;
+
+            wall.draw();
+            glfwSwapBuffers(window);
+
+            deadline += period;
+            auto now = FramePacer::clock::now();
+            if (deadline < now - period * 4) {
+                deadline = now;
+            }
+            pacer.waitUntil(deadline);
+
+            if (now - lastReport > std::chrono::seconds(5)) {
+                wall.report("Wall");
+                std::cout << pacer.summary() << std::endl;
+                lastReport = now;
+            }
+        }
+    }
+
+    for (Chip8 *machine : machines) {
+        pool.giveBack(machine);
+    }
+    glfwTerminate();
+    return 0;
+}